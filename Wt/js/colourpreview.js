@@ -0,0 +1,156 @@
+/**
+ *  @file       colourpreview.js
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application colour picker previews
+ *
+ *  @section    DESCRIPTION
+ *
+ *              The colour pickers of the light management screen are recoloured in the
+ *              browser while their sliders move, so previews never reach the server. A
+ *              picker is any element with a data-preview attribute of rgb, hs or ct whose
+ *              range inputs are its sliders in order. One listener on the document serves
+ *              every picker, so pickers moved between dialogs need no set up. The
+ *              conversions follow ColourConvert: RGB is moved into the gamut set on the
+ *              picker in data-gamut, hue/sat/bri uses the same HSV formula and colour
+ *              temperature uses the same black body fit as the server tables.
+ */
+
+var Ambience = window.Ambience || {};
+window.Ambience = Ambience;
+
+/**
+ *   @brief  Value of a slider, 0 if it has not been rendered yet
+ */
+Ambience.sliderValue = function(slider) {
+    return slider ? Number(slider.value) || 0 : 0;
+};
+
+/**
+ *   @brief  Recolour the picker holding a slider that moved
+ */
+Ambience.preview = function(e) {
+    var container = e.target && e.target.closest ? e.target.closest('[data-preview]') : null;
+    if (!container) return;
+
+    var sliders = container.querySelectorAll('input[type=range]');
+    var kind = container.getAttribute('data-preview');
+    if (kind == 'rgb') Ambience.rgbPreview(container, sliders[0], sliders[1], sliders[2]);
+    else if (kind == 'hs') Ambience.hsPreview(container, sliders[0], sliders[1], sliders[2]);
+    else if (kind == 'ct') Ambience.ctPreview(container, sliders[0], sliders[1]);
+};
+
+if (!Ambience.listening) {
+    Ambience.listening = true;
+    document.addEventListener('input', Ambience.preview);
+}
+
+/**
+ *   @brief  Set the background of a picker
+ */
+Ambience.setPreview = function(container, r, g, b) {
+    if (!container) return;
+    var clamp = function(c) { return Math.max(0, Math.min(255, Math.round(c))); };
+    container.style.backgroundColor = 'rgb(' + clamp(r) + ',' + clamp(g) + ',' + clamp(b) + ')';
+};
+
+/**
+ *   @brief  Closest point to p on the segment from a to b, with its squared distance
+ */
+Ambience.closestOnSegment = function(px, py, ax, ay, bx, by) {
+    var abx = bx - ax, aby = by - ay;
+    var t = ((px - ax) * abx + (py - ay) * aby) / (abx * abx + aby * aby);
+    t = Math.max(0, Math.min(1, t));
+    var x = ax + abx * t, y = ay + aby * t;
+    return {x: x, y: y, d: (px - x) * (px - x) + (py - y) * (py - y)};
+};
+
+/**
+ *   @brief  RGB picker preview, the slider colour moved into the gamut of the light
+ */
+Ambience.rgbPreview = function(container, redSlider, greenSlider, blueSlider) {
+    var red = Ambience.sliderValue(redSlider);
+    var green = Ambience.sliderValue(greenSlider);
+    var blue = Ambience.sliderValue(blueSlider);
+    var gamut = container ? (container.getAttribute('data-gamut') || '').split(',').map(Number) : [];
+
+    if (gamut.length == 6) {
+        var decode = function(c) {
+            c = c / 255;
+            return c > 0.04045 ? Math.pow((c + 0.055) / 1.055, 2.4) : c / 12.92;
+        };
+        var lr = decode(red), lg = decode(green), lb = decode(blue);
+        var X = lr * 0.649926 + lg * 0.103455 + lb * 0.197109;
+        var Y = lr * 0.234327 + lg * 0.743075 + lb * 0.022598;
+        var Z = lr * 0.000000 + lg * 0.053077 + lb * 1.035763;
+        var sum = X + Y + Z;
+        var x = sum != 0 ? X / sum : 0, y = sum != 0 ? Y / sum : 0;
+
+        var d1 = (gamut[2] - gamut[0]) * (y - gamut[1]) - (gamut[3] - gamut[1]) * (x - gamut[0]);
+        var d2 = (gamut[4] - gamut[2]) * (y - gamut[3]) - (gamut[5] - gamut[3]) * (x - gamut[2]);
+        var d3 = (gamut[0] - gamut[4]) * (y - gamut[5]) - (gamut[1] - gamut[5]) * (x - gamut[4]);
+        var outside = (d1 < 0 || d2 < 0 || d3 < 0) && (d1 > 0 || d2 > 0 || d3 > 0);
+
+        if (outside) {
+            var best = Ambience.closestOnSegment(x, y, gamut[0], gamut[1], gamut[2], gamut[3]);
+            var edge = Ambience.closestOnSegment(x, y, gamut[2], gamut[3], gamut[4], gamut[5]);
+            if (edge.d < best.d) best = edge;
+            edge = Ambience.closestOnSegment(x, y, gamut[4], gamut[5], gamut[0], gamut[1]);
+            if (edge.d < best.d) best = edge;
+
+            // xy back to RGB, then keep the brightest channel of the slider colour
+            var bY = Math.max(0, Math.min(1, Y));
+            var bX = (bY / best.y) * best.x, bZ = (bY / best.y) * (1 - best.x - best.y);
+            var encode = function(c) {
+                c = c <= 0.0031308 ? 12.92 * c : 1.055 * Math.pow(c, 1 / 2.4) - 0.055;
+                return Math.max(0, Math.min(255, c * 255)) || 0;
+            };
+            var cr = encode(bX * 3.2410 - bY * 1.5374 - bZ * 0.4986);
+            var cg = encode(-bX * 0.9692 + bY * 1.8760 + bZ * 0.0416);
+            var cb = encode(bX * 0.0556 - bY * 0.2040 + bZ * 1.0570);
+            var peak = Math.max(cr, cg, cb);
+            var scale = peak > 0 ? Math.max(red, green, blue) / peak : 0;
+            red = cr * scale;
+            green = cg * scale;
+            blue = cb * scale;
+        }
+    }
+    Ambience.setPreview(container, red, green, blue);
+};
+
+/**
+ *   @brief  Hue/saturation picker preview, hue 0-65280, sat 0-255 and bri 0-254 as the lights use
+ */
+Ambience.hsPreview = function(container, hueSlider, satSlider, briSlider) {
+    var h = Ambience.sliderValue(hueSlider) / 65280 * 360;
+    var s = Ambience.sliderValue(satSlider) / 255;
+    var v = Ambience.sliderValue(briSlider) / 254;
+
+    if (s <= 0) {
+        Ambience.setPreview(container, v * 254, v * 254, v * 254);
+        return;
+    }
+
+    var hh = h >= 360 ? 0 : h / 60;
+    var i = Math.floor(hh), ff = hh - i;
+    var p = v * (1 - s), q = v * (1 - s * ff), t = v * (1 - s * (1 - ff));
+    var rgb = [[v, t, p], [q, v, p], [p, v, t], [p, q, v], [t, p, v], [v, p, q]][Math.min(i, 5)];
+    Ambience.setPreview(container, rgb[0] * 255, rgb[1] * 255, rgb[2] * 255);
+};
+
+/**
+ *   @brief  Colour temperature picker preview, ct in mired and bri 0-254
+ */
+Ambience.ctPreview = function(container, ctSlider, briSlider) {
+    var ct = Math.max(153, Math.min(500, Ambience.sliderValue(ctSlider)));
+    var scale = Ambience.sliderValue(briSlider) / 254;
+    var t = 1000000 / ct / 100;
+
+    var r = t <= 66 ? 255 : 329.698727446 * Math.pow(t - 60, -0.1332047592);
+    var g = t <= 66 ? 99.4708025861 * Math.log(t) - 161.1195681661 : 288.1221695283 * Math.pow(t - 60, -0.0755148492);
+    var b = t >= 66 ? 255 : (t <= 19 ? 0 : 138.5177312231 * Math.log(t - 10) - 305.0447927307);
+    var clamp = function(c) { return Math.max(0, Math.min(255, c)); };
+    Ambience.setPreview(container, clamp(r) * scale, clamp(g) * scale, clamp(b) * scale);
+};
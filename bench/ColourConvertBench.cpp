@@ -0,0 +1,237 @@
+/**
+ *  @file       ColourConvertBench.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application accuracy check and benchmark of ColourConvert
+ *
+ *  @section    DESCRIPTION
+ *
+ *              Converts a grid of xy colours and every 8-bit RGB colour on a coarse cube with
+ *              ColourConvert and compares the results against the same conversions done with
+ *              pow() per channel. The table based gamma steps must stay within
+ *              ColourConvert::GAMMA_TOLERANCE on the 0-255 scale, and the batch forms must agree
+ *              with the single colour forms. Then the conversions per second of the single
+ *              colour forms, of the batch forms, which use SSE2 where the build offers it, and
+ *              of pow() are printed. Exits with 1 if a check fails.
+ */
+
+#include "ColourConvert.h"
+#include <chrono>
+#include <iostream>
+#include <math.h>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+#ifdef __SSE2__
+const char *BATCH = "SSE2"; // what the batch forms were built with
+#else
+const char *BATCH = "scalar";
+#endif
+
+/**
+ *   @brief  XY to RGB with the exact sRGB gamma step, the conversion before the gamma tables
+ *
+ *   @param  x is the X component of the colour
+ *   @param  y is the Y component of the colour
+ *   @param  brightness is the brightness value of the light
+ *
+ *   @return struct rgb the colour on the 0-255 scale
+ */
+struct rgb referenceXy2rgb(float x, float y, float brightness)
+{
+    float z = 1.0f - x - y;
+    float Y = brightness / 254.0f;
+    float X = (Y / y) * x;
+    float Z = (Y / y) * z;
+
+    float channels[3] = {X * 3.2410f - Y * 1.5374f - Z * 0.4986f,
+                         -X * 0.9692f + Y * 1.8760f + Z * 0.0416f,
+                         X * 0.0556f - Y * 0.2040f + Z * 1.0570f};
+    for (int i = 0; i < 3; i++) {
+        float c = channels[i];
+        c = c <= 0.0031308f ? 12.92f * c : (1.0f + 0.055f) * pow(c, (1.0f / 2.4f)) - 0.055f;
+        channels[i] = c > 0 ? (c * 255 > 255 ? 255 : c * 255) : 0;
+    }
+
+    struct rgb out;
+    out.r = channels[0];
+    out.g = channels[1];
+    out.b = channels[2];
+    out.brightness = brightness;
+    return out;
+}
+
+/**
+ *   @brief  RGB to XY with the exact sRGB gamma step, the conversion before the gamma tables
+ *
+ *   @param  r is the red component of the colour
+ *   @param  g is the green component of the colour
+ *   @param  b is the blue component of the colour
+ *
+ *   @return struct xy the colour
+ */
+struct xy referenceRgb2xy(float r, float g, float b)
+{
+    float channels[3] = {r / 255.0f, g / 255.0f, b / 255.0f};
+    for (int i = 0; i < 3; i++) {
+        float c = channels[i];
+        channels[i] = (c > 0.04045f) ? pow((c + 0.055f) / (1.0f + 0.055f), 2.4f) : (c / 12.92f);
+    }
+
+    float X = channels[0] * 0.649926f + channels[1] * 0.103455f + channels[2] * 0.197109f;
+    float Y = channels[0] * 0.234327f + channels[1] * 0.743075f + channels[2] * 0.022598f;
+    float Z = channels[1] * 0.053077f + channels[2] * 1.035763f;
+
+    struct xy out;
+    out.x = (X + Y + Z) != 0 ? X / (X + Y + Z) : 0;
+    out.y = (X + Y + Z) != 0 ? Y / (X + Y + Z) : 0;
+    out.brightness = (Y < 0 ? 0 : (Y > 1 ? 1 : Y)) * 254.0f;
+    return out;
+}
+
+/**
+ *   @brief  Largest channel difference of two RGB colours
+ */
+float rgbError(const struct rgb &a, const struct rgb &b)
+{
+    return fmax(fabs(a.r - b.r), fmax(fabs(a.g - b.g), fabs(a.b - b.b)));
+}
+
+/**
+ *   @brief  Largest component difference of two xy colours, brightness scaled to 0-1
+ */
+float xyError(const struct xy &a, const struct xy &b)
+{
+    return fmax(fabs(a.x - b.x), fmax(fabs(a.y - b.y), fabs(a.brightness - b.brightness) / 254.0f));
+}
+
+/**
+ *   @brief  Seconds since start
+ */
+double elapsed(chrono::steady_clock::time_point start)
+{
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+}
+
+int main()
+{
+    const float XY_TOLERANCE = 0.0001f; // largest xy difference of the tables, no gamma encode is involved
+    bool failed = false;
+
+    // xy colours inside the widest gamut at every 8th brightness
+    vector<struct xy> xys;
+    for (int i = 1; i < 100; i++) {
+        for (int j = 1; i + j < 100; j++) {
+            for (int bri = 1; bri <= 254; bri += 8) {
+                struct xy colour = {i / 100.0f, j / 100.0f, (float)bri};
+                xys.push_back(colour);
+            }
+        }
+    }
+
+    // 8-bit RGB colours on a cube of every 5th value
+    vector<struct rgb> rgbs;
+    for (int r = 0; r <= 255; r += 5) {
+        for (int g = 0; g <= 255; g += 5) {
+            for (int b = 0; b <= 255; b += 5) {
+                struct rgb colour = {(float)r, (float)g, (float)b, 0};
+                rgbs.push_back(colour);
+            }
+        }
+    }
+
+    // accuracy of the single colour forms against pow()
+    float worstRgb = 0;
+    for (const struct xy &colour : xys) {
+        worstRgb = fmax(worstRgb, rgbError(ColourConvert::xy2rgb(colour.x, colour.y, colour.brightness),
+                                           referenceXy2rgb(colour.x, colour.y, colour.brightness)));
+    }
+    float worstXy = 0;
+    for (const struct rgb &colour : rgbs) {
+        worstXy = fmax(worstXy, xyError(ColourConvert::rgb2xy(colour.r, colour.g, colour.b),
+                                        referenceRgb2xy(colour.r, colour.g, colour.b)));
+    }
+
+    cout << "xy2rgb largest difference from pow(): " << worstRgb << " (tolerance " << ColourConvert::GAMMA_TOLERANCE << ")\n";
+    cout << "rgb2xy largest difference from pow(): " << worstXy << " (tolerance " << XY_TOLERANCE << ")\n";
+    if (worstRgb > ColourConvert::GAMMA_TOLERANCE || worstXy > XY_TOLERANCE) {
+        cerr << "FAIL: gamma tables are outside the tolerance\n";
+        failed = true;
+    }
+
+    // the batch forms against the single colour forms
+    vector<struct rgb> rgbOut(xys.size());
+    vector<struct xy> xyOut(rgbs.size());
+    ColourConvert::xy2rgbBatch(xys.data(), rgbOut.data(), xys.size());
+    ColourConvert::rgb2xyBatch(rgbs.data(), xyOut.data(), rgbs.size());
+
+    float batchRgb = 0;
+    for (size_t i = 0; i < xys.size(); i++) {
+        batchRgb = fmax(batchRgb, rgbError(rgbOut[i], ColourConvert::xy2rgb(xys[i].x, xys[i].y, xys[i].brightness)));
+    }
+    float batchXy = 0;
+    for (size_t i = 0; i < rgbs.size(); i++) {
+        batchXy = fmax(batchXy, xyError(xyOut[i], ColourConvert::rgb2xy(rgbs[i].r, rgbs[i].g, rgbs[i].b)));
+    }
+
+    cout << "xy2rgbBatch largest difference from xy2rgb: " << batchRgb << "\n";
+    cout << "rgb2xyBatch largest difference from rgb2xy: " << batchXy << "\n";
+    if (batchRgb > ColourConvert::GAMMA_TOLERANCE || batchXy > XY_TOLERANCE) {
+        cerr << "FAIL: batch conversions differ from the single colour conversions\n";
+        failed = true;
+    }
+
+    // throughput, each pass converts every colour of the grid
+    const int PASSES = 20;
+    float sink = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (const struct xy &colour : xys) {
+            sink += ColourConvert::xy2rgb(colour.x, colour.y, colour.brightness).r;
+        }
+    }
+    cout << "xy2rgb (scalar): " << (long)(PASSES * xys.size() / elapsed(start)) << " conversions/s\n";
+
+    start = chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        ColourConvert::xy2rgbBatch(xys.data(), rgbOut.data(), xys.size());
+        sink += rgbOut[pass].r;
+    }
+    cout << "xy2rgbBatch (" << BATCH << "): " << (long)(PASSES * xys.size() / elapsed(start)) << " conversions/s\n";
+
+    start = chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (const struct xy &colour : xys) {
+            sink += referenceXy2rgb(colour.x, colour.y, colour.brightness).r;
+        }
+    }
+    cout << "xy2rgb with pow(): " << (long)(PASSES * xys.size() / elapsed(start)) << " conversions/s\n";
+
+    start = chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        for (const struct rgb &colour : rgbs) {
+            sink += ColourConvert::rgb2xy(colour.r, colour.g, colour.b).x;
+        }
+    }
+    cout << "rgb2xy (scalar): " << (long)(PASSES * rgbs.size() / elapsed(start)) << " conversions/s\n";
+
+    start = chrono::steady_clock::now();
+    for (int pass = 0; pass < PASSES; pass++) {
+        ColourConvert::rgb2xyBatch(rgbs.data(), xyOut.data(), rgbs.size());
+        sink += xyOut[pass].x;
+    }
+    cout << "rgb2xyBatch (" << BATCH << "): " << (long)(PASSES * rgbs.size() / elapsed(start)) << " conversions/s\n";
+
+    // keeps the conversions from being optimised away
+    if (sink == -1) cout << sink;
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,102 @@
+/**
+ *  @file       HashBench.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application check and benchmark of password hashing
+ *
+ *  @section    DESCRIPTION
+ *
+ *              Checks that PBKDF2 hashes verify the right password only, that older plain SHA256
+ *              hashes still verify and are reported for rehashing. Then, for a range of iteration
+ *              counts, queues logins on HashPool the way the login screen does, outside of a
+ *              session so the results come back on the workers, and prints the time per hash and
+ *              the logins per second the server can accept at that cost. Exits with 1 if a check
+ *              fails.
+ */
+
+#include "Hash.h"
+#include "HashPool.h"
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+
+using namespace std;
+
+namespace {
+
+/**
+ *   @brief  Print a failed check
+ *
+ *   @param  ok is the result of the check
+ *   @param  what describes the check
+ *
+ *   @return bool ok
+ */
+bool check(bool ok, const string &what)
+{
+    if (!ok) cerr << "FAIL: " << what << "\n";
+    return ok;
+}
+
+}
+
+int main()
+{
+    bool passed = true;
+
+    // correctness at the default cost
+    string stored = Hash::hashPassword("correct horse");
+    passed &= check(stored != "", "hashPassword returned no hash");
+    passed &= check(Hash::verifyPassword("correct horse", stored), "the right password was refused");
+    passed &= check(!Hash::verifyPassword("wrong horse", stored), "a wrong password was accepted");
+    passed &= check(!Hash::needsRehash(stored), "a new hash was reported for rehashing");
+    passed &= check(Hash::hashPassword("correct horse") != stored, "two hashes of a password share a salt");
+
+    string legacy = Hash::sha256_hash("correct horse");
+    passed &= check(Hash::verifyPassword("correct horse", legacy), "a plain SHA256 hash was refused");
+    passed &= check(Hash::needsRehash(legacy), "a plain SHA256 hash was not reported for rehashing");
+
+    // logins per second against the cost, each login is one verify on the pool
+    const int costs[] = {10000, 25000, 50000, Hash::DEFAULT_ITERATIONS, 200000};
+    const int LOGINS = 8 * HashPool::THREADS; // verifies timed at each cost, fewer than HashPool::QUEUE_LIMIT
+    mutex resultsMutex;
+    condition_variable resultsReady;
+
+    cout << "iterations  ms/hash  logins/s (" << HashPool::THREADS << " threads)\n";
+    for (int cost : costs) {
+        Hash::setIterations(cost);
+        string hash = Hash::hashPassword("correct horse");
+        passed &= check(!Hash::needsRehash(hash), "a hash at the current cost was reported for rehashing");
+
+        int results = 0;
+        int refused = 0;
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        for (int i = 0; i < LOGINS; i++) {
+            // without a session id the pool runs the callback on its worker
+            bool queued = HashPool::instance()->verify("correct horse", hash, "", [&](bool matched, string) {
+                lock_guard<mutex> lock(resultsMutex);
+                if (!matched) refused++;
+                results++;
+                resultsReady.notify_one();
+            });
+            passed &= check(queued, "the pool refused a login below its queue limit");
+            if (!queued) {
+                lock_guard<mutex> lock(resultsMutex);
+                results++;
+            }
+        }
+        {
+            unique_lock<mutex> lock(resultsMutex);
+            resultsReady.wait(lock, [&] { return results == LOGINS; });
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        passed &= check(refused == 0, "the right password was refused under load");
+
+        cout << cost << "  " << seconds * 1000 * HashPool::THREADS / LOGINS << "  " << (long)(LOGINS / seconds) << "\n";
+    }
+
+    return passed ? 0 : 1;
+}
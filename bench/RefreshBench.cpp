@@ -0,0 +1,170 @@
+/**
+ *  @file       RefreshBench.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application check that refreshing a bridge does not leak
+ *
+ *  @section    DESCRIPTION
+ *
+ *              Refreshes a bridge of 50 lights, 16 groups and 16 schedules 10,000 times the way
+ *              a session does: the body is streamed through BridgeParser, merged into a copy of
+ *              the last snapshot, a light command is applied to it, and the lights, groups and
+ *              schedules tables are read back from it. Every allocation is counted, and the
+ *              allocations still alive must not grow after the first refreshes. Exits with 1 if
+ *              they do.
+ */
+
+#include "BridgeParser.h"
+#include "BridgeState.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <stdlib.h>
+#include <string>
+
+using namespace std;
+
+namespace {
+
+atomic<long> liveAllocations(0); // allocations made with new and not deleted yet
+
+/**
+ *   @brief  Body of GET /api/<username> for a bridge with the given number of entries
+ *
+ *   @param  lights is the number of lights
+ *   @param  groups is the number of groups
+ *   @param  schedules is the number of schedules
+ *
+ *   @return string the JSON body
+ */
+string bridgeBody(int lights, int groups, int schedules)
+{
+    string body = "{\"lights\":{";
+    for (int i = 1; i <= lights; i++) {
+        string num = to_string(i);
+        body += (i > 1 ? "," : "") + string("\"") + num + "\":{\"state\":{\"on\":true,\"bri\":" + to_string(i % 254) +
+                ",\"hue\":" + to_string(i * 1000) + ",\"sat\":200,\"xy\":[0.4,0.4],\"ct\":300,\"alert\":\"none\"," +
+                "\"effect\":\"none\",\"colormode\":\"xy\",\"reachable\":true},\"type\":\"Extended color light\"," +
+                "\"name\":\"Light " + num + "\",\"modelid\":\"LCT001\",\"swversion\":\"66009461\"}";
+    }
+    body += "},\"groups\":{";
+    for (int i = 1; i <= groups; i++) {
+        string num = to_string(i);
+        body += (i > 1 ? "," : "") + string("\"") + num + "\":{\"name\":\"Group " + num + "\",\"lights\":[\"" +
+                to_string(i) + "\",\"" + to_string(i + 1) + "\"],\"action\":{\"on\":true,\"bri\":100,\"hue\":1000," +
+                "\"sat\":200,\"xy\":[0.4,0.4],\"ct\":300,\"alert\":\"none\",\"effect\":\"none\",\"colormode\":\"xy\"}}";
+    }
+    body += "},\"schedules\":{";
+    for (int i = 1; i <= schedules; i++) {
+        string num = to_string(i);
+        body += (i > 1 ? "," : "") + string("\"") + num + "\":{\"name\":\"Schedule " + num + "\",\"description\":\"\"," +
+                "\"command\":{\"address\":\"/api/newdeveloper/lights/" + num + "/state\",\"method\":\"PUT\"," +
+                "\"body\":{\"on\":true,\"bri\":100}},\"time\":\"2026-10-17T18:00:00\"}";
+    }
+    body += "},\"config\":{\"name\":\"Philips hue\",\"modelid\":\"BSB001\",\"swversion\":\"01012917\","
+            "\"apiversion\":\"1.3.0\",\"mac\":\"00:17:88:00:00:00\"}}";
+    return body;
+}
+
+/**
+ *   @brief  Read every row of the tables from a snapshot, as the light management page does
+ *
+ *   @param  &state is the snapshot
+ *
+ *   @return size_t characters read, so the reads are not optimised away
+ */
+size_t readTables(BridgeState &state)
+{
+    size_t read = 0;
+    for (auto &light : state.getLights()) {
+        read += light.second.getName().toUTF8().size() + light.second.getBri() + light.second.getOn();
+    }
+    for (auto &group : state.getGroups()) {
+        read += group.second.getName().toUTF8().size() + group.second.getLights().size();
+    }
+    for (auto &schedule : state.getSchedules()) {
+        read += schedule.second.getName().toUTF8().size() + schedule.second.getTime().toUTF8().size();
+    }
+    return read;
+}
+
+}
+
+// every allocation of the process goes through these, so growth anywhere in a refresh shows up
+void *operator new(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+    if (!p) throw bad_alloc();
+    liveAllocations++;
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    if (!p) return;
+    liveAllocations--;
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    operator delete(p);
+}
+
+int main()
+{
+    const int REFRESHES = 10000; // refreshes of the bridge, a long kiosk session
+    const int WARMUP = 100; // refreshes before the baseline is taken, caches fill up here
+    const size_t CHUNK = 1024; // bytes per piece of the streamed body
+
+    string body = bridgeBody(50, 16, 16);
+    shared_ptr<BridgeState> snapshot = make_shared<BridgeState>();
+    long baseline = 0;
+    size_t read = 0;
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < REFRESHES; i++) {
+        if (i == WARMUP) baseline = liveAllocations;
+
+        BridgeParser parser;
+        for (size_t pos = 0; pos < body.size(); pos += CHUNK) {
+            parser.feed(body.substr(pos, CHUNK));
+        }
+        shared_ptr<BridgeState> parsed = parser.finish();
+        if (!parsed) {
+            cerr << "FAIL: the bridge body could not be parsed\n";
+            return 1;
+        }
+
+        // the registry never changes a published snapshot, it replaces it with a merged copy
+        shared_ptr<BridgeState> next = make_shared<BridgeState>(*snapshot);
+        next->merge(*parsed);
+        next->applyResponse("/lights/1/state", "{\"bri\":" + to_string(i % 254) + "}",
+                            "[{\"success\":{\"/lights/1/state/bri\":" + to_string(i % 254) + "}}]");
+        snapshot = next;
+
+        read += readTables(*snapshot);
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    long grown = liveAllocations - baseline;
+
+    cout << "refreshes: " << REFRESHES << ", " << (long)(REFRESHES / seconds) << " refreshes/s\n";
+    cout << "allocations alive after " << WARMUP << " refreshes: " << baseline
+         << ", after " << REFRESHES << ": " << (long)liveAllocations << "\n";
+    if (read == 0) cout << read;
+
+    if (grown > 0) {
+        cerr << "FAIL: " << grown << " allocations leaked over " << REFRESHES - WARMUP << " refreshes\n";
+        return 1;
+    }
+    return 0;
+}
@@ -1,6 +1,9 @@
 #ifndef ACCOUNT_H
 #define ACCOUNT_H
 #include <string>
+#include <boost/function.hpp>
+#include <memory>
+#include <mutex>
 #include "Bridge.h"
 #include <vector>
 
@@ -13,35 +16,44 @@ private:
     string lastName_;
     string email_;
     string password_;
+    string picture_; // id of the profile picture, empty for the default picture
     bool auth_;
-    vector<Bridge> bridges;
+    shared_ptr<const vector<Bridge> > bridges; // replaced on every change, so readers can keep a snapshot
+    mutable mutex mutex_; // guards the fields, an account is shared by every session of its user
 
 public:
     Account(string fn, string ln, string em, string pw);
+    Account(const Account &other);
+    Account &operator=(const Account &other);
     virtual ~Account();
 
     //Name, email, and password getters/setters
-    string getFirstName() {return firstName_;}
-    string getLastName() {return lastName_;}
-    string getEmail() {return email_;}
-    string getPassword() {return password_;}
-    bool isAuth() {return auth_;}
-    vector<Bridge> getBridges() {return bridges;}
-    int getNumBridges() {return bridges.size();}
-    Bridge* getBridgeAt(int index);
+    string getFirstName() const;
+    string getLastName() const;
+    string getEmail() const;
+    string getPassword() const;
+    string getPicture() const;
+    bool isAuth() const;
+    shared_ptr<const vector<Bridge> > getBridges() const;
+    int getNumBridges() const;
+    Bridge getBridgeAt(int index) const;
 
-    void setFirstName(string fn) {firstName_ = fn;}
-    void setLastName(string ln) {lastName_ = ln;}
-    void setEmail(string em) {email_ = em;}
-    void setPassword(string pw) {password_ = pw;}
-    void setAuth(bool val) {auth_ = val;}
+    void setFirstName(string fn);
+    void setLastName(string ln);
+    void setEmail(string em);
+    void setPassword(string pw);
+    void setPicture(string pic);
+    void setAuth(bool val);
     
     void addBridge(Bridge br);
     void addBridge(string bname, string bloc, string bip,
                    string bport, string buser);
+    void setBridgeAt(int index, Bridge br);
     void removeBridgeAt(int index);
+    int findBridge(const Bridge &bridge) const;
     
-    void writeFile();
+    bool update(const boost::function<void (Account &)> &mutation);
+    void refresh(const Account &stored);
 
 };
 
@@ -0,0 +1,35 @@
+#ifndef ACCOUNTREGISTRY_H
+#define ACCOUNTREGISTRY_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include "Account.h"
+
+using namespace std;
+
+class AccountRegistry {
+
+public:
+    static AccountRegistry *instance();
+
+    shared_ptr<Account> acquire(const string &email);
+    void refresh(const string &email, const Account &stored);
+
+private:
+    AccountRegistry();
+
+    // account being loaded by acquire, outside of mutex_
+    struct Loading {
+        Loading() : loaders(0) {}
+        int loaders; // acquires loading the account
+        shared_ptr<Account> latest; // latest edit stored while they load, newer than what they read
+    };
+
+    mutex mutex_; // guards accounts_ and loading_, sessions of every thread log in through here
+    unordered_map<string, weak_ptr<Account> > accounts_; // accounts by email, alive while a session holds them
+    unordered_map<string, Loading> loading_; // accounts being loaded by email
+};
+
+#endif //ACCOUNTREGISTRY_H
@@ -0,0 +1,72 @@
+#ifndef ACCOUNTSTORE_H
+#define ACCOUNTSTORE_H
+
+#include <Wt/Dbo/Dbo>
+#include <Wt/Dbo/backend/Sqlite3>
+#include <boost/function.hpp>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include "Account.h"
+
+using namespace std;
+using namespace Wt;
+
+class AccountStore {
+
+public:
+    static AccountStore *instance();
+
+    bool exists(const string &email);
+    bool load(const string &email, Account &account);
+    bool create(const string &email, const string &password, const string &firstName, const string &lastName);
+    bool update(const string &email, const boost::function<void (Account &)> &mutation, Account &result);
+    bool addBridge(const string &email, const Bridge &bridge);
+    void flush();
+
+    void setFlushLatency(int latency);
+    int getFlushLatency();
+
+    static const char *DATABASE; // SQLite file holding the accounts and their bridges
+    static const char *CREDENTIALS_DIR; // directory of the text files accounts were kept in before
+    static const int FLUSH_LATENCY = 500; // default milliseconds a saved account waits to be written
+    static const int LOCK_STRIPES = 64; // locks the accounts are spread over
+
+private:
+    AccountStore();
+
+    bool tableExists(const string &table);
+    bool columnExists(const string &table, const string &column);
+    void importCredentials();
+    void importPictures();
+    void loadIndex();
+    bool indexed(const string &email);
+    bool unwritten(const string &email, Account &account);
+    void save(Account &account);
+    void write(Account &account);
+    mutex &stripe(const string &email);
+
+    mutex mutex_; // guards session_, a Dbo session is not thread safe
+    unique_ptr<Dbo::backend::Sqlite3> connection_; // connection to DATABASE
+    Dbo::Session session_; // maps the account and bridge tables
+
+    mutex readMutex_; // guards readSession_
+    unique_ptr<Dbo::backend::Sqlite3> readConnection_; // second connection to DATABASE, WAL lets it read while a flush writes
+    Dbo::Session readSession_; // reads accounts with plain row queries, so nothing is cached between reads
+
+    mutex indexMutex_; // guards emails_
+    unordered_set<string> emails_; // email of every account, unknown emails are answered without the database
+
+    mutex stripes_[LOCK_STRIPES]; // an edit of an account holds the stripe of its email, edits of other stripes run alongside
+
+    mutex pendingMutex_; // guards pending_, flushing_, flushArmed_ and flushLatency_, never held while writing
+    map<string, Account> pending_; // saved accounts not written yet by email, the latest save of each
+    map<string, Account> flushing_; // accounts being written by the running flush
+    bool flushArmed_; // a flush is scheduled
+    int flushLatency_; // milliseconds from the first pending save to its flush
+};
+
+#endif //ACCOUNTSTORE_H
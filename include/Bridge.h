@@ -16,8 +16,9 @@
 #include <sstream>
 #include <fstream>
 #include <string>
+#include <memory>
 #include <Wt/Json/Object>
-//#include "Light.h" //todo: implement
+#include "BridgeState.h"
 
 using namespace std;
 using namespace Wt;
@@ -33,16 +34,14 @@ public:
     virtual ~Bridge();
 
     //GETTER METHODS
-    string getName() {return bridgename_;}
-    string getLocation() {return location_;}
-    string getIP() {return ip_;}
-    string getPort() {return port_;}
-    string getUsername() {return username_;}
-    string getJson() {return json_;}
-    
-    /*vector<Light> getLights() {return lights;} //todo: implement
-    int getNumLights() {return lights.size();} //todo: implement
-    Light* getLightAt(int index); //todo: implement*/
+    const string &getName() const {return bridgename_;}
+    const string &getLocation() const {return location_;}
+    const string &getIP() const {return ip_;}
+    const string &getPort() const {return port_;}
+    const string &getUsername() const {return username_;}
+    string getKey() const {return ip_ + ":" + port_ + ":" + username_;}
+    BridgeState *getState() const {return state_.get();}
+    shared_ptr<BridgeState> getSharedState() const {return state_;}
 
     //SETTER METHODS
     void setName(string name) {bridgename_ = name;}
@@ -50,13 +49,8 @@ public:
     void setIP(string ip) {ip_ = ip;}
     void setPort(string port) {port_ = port;}
     void setUsername(string username) {username_ = username;}
-    
-    void setJson(string json) {json_ = json;}
-    
-    /*void addLight(Light li); //todo: implement
-    void addLight(string type, string name, string modelid,
-                  string swversion, string uniqueid, struct state_t state); //todo: implement
-    void removeLightAt(int index); //todo: implement*/
+
+    void setState(shared_ptr<BridgeState> state);
 
 private:
     string bridgename_;
@@ -64,8 +58,7 @@ private:
     string ip_;
     string port_;
     string username_;
-    string json_;
-    //vector<Light> lights; //todo: implement
+    shared_ptr<BridgeState> state_; // parsed lights, groups, schedules and config, shared between sessions
 };
 
 #endif
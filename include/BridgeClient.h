@@ -0,0 +1,93 @@
+#ifndef BRIDGECLIENT_H
+#define BRIDGECLIENT_H
+
+#include <Wt/WObject>
+#include <Wt/Http/Client>
+#include <Wt/Http/Message>
+#include <Wt/Json/Object>
+#include <Wt/Json/Value>
+#include <boost/function.hpp>
+#include "BridgeScheduler.h"
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace Wt;
+
+class BridgeClient : public Wt::WObject {
+
+public:
+    typedef boost::function<void (boost::system::error_code, const Http::Message &)> Callback;
+    typedef boost::function<void (const string &)> DataCallback;
+
+    BridgeClient(string ip, string port, Wt::WObject *parent = 0);
+
+    virtual ~BridgeClient();
+
+    void get(const string &url, Wt::WObject *owner, const Callback &done,
+             BridgeScheduler::Priority priority = BridgeScheduler::Background);
+    void getStreaming(const string &url, Wt::WObject *owner, const DataCallback &data, const Callback &done,
+                      BridgeScheduler::Priority priority = BridgeScheduler::Background);
+    void put(const string &url, const string &body, Wt::WObject *owner, const Callback &done);
+    void post(const string &url, const string &body, Wt::WObject *owner, const Callback &done);
+    void deleteRequest(const string &url, Wt::WObject *owner, const Callback &done);
+    void putLatest(const string &url, const Json::Object &body, Wt::WObject *owner, const Callback &done);
+    void cancel(Wt::WObject *owner);
+
+    //GETTERS
+    string getIP() {return ip_;}
+    string getPort() {return port_;}
+    int getActive() {return active_.size();}
+    int getQueued() {return scheduled_.size() + queue_.size();}
+
+    static const int MAX_CONNECTIONS = 2; // requests sent to the bridge at the same time
+    static const int TIMEOUT = 2; // seconds before a request is abandoned
+    static const int MAX_RESPONSE_SIZE = 1000000; // largest accepted response body in bytes
+    static const int MAX_STREAM_SIZE = 64000000; // largest streamed response body in bytes, it is not kept in memory
+
+private:
+    struct Request {
+        string method; // GET, PUT, POST or DELETE
+        string url;
+        string body;
+        Wt::WObject *owner; // object the callback belongs to, 0 once cancelled
+        DataCallback data; // receives the body in chunks instead of the response, streamed GET only
+        Callback done;
+    };
+
+    // PUT commands to one url merged while an earlier command to it is in flight
+    struct Coalesced {
+        Coalesced() : inFlight(false) {}
+        bool inFlight; // a merged command to the url is being sent
+        Json::Object body; // newest value of each attribute not yet sent
+        vector<pair<Wt::WObject *, Callback> > waiting; // callbacks of the commands merged into body
+        vector<pair<Wt::WObject *, Callback> > sent; // callbacks of the command in flight
+    };
+
+    void sendLatest(const string &url);
+    void handleLatest(const string &url, boost::system::error_code err, const Http::Message &response);
+    void enqueue(const string &method, const string &url, const string &body, Wt::WObject *owner, const Callback &done,
+                 BridgeScheduler::Priority priority, const DataCallback &data = DataCallback());
+    void granted(int id);
+    void dispatch();
+    bool send(Http::Client *client, const Request &request);
+    void handleData(Http::Client *client, const string &data);
+    void handleDone(Http::Client *client, boost::system::error_code err, const Http::Message &response);
+
+    static string bridgeKey(const string &ip, const string &port, const string &url);
+    static BridgeScheduler::Budget budget(const string &url);
+
+    string ip_;
+    string port_;
+    int nextId_; // id of the next request handed to the scheduler
+    map<int, Request> scheduled_; // requests waiting on the bridge rate limit by id
+    deque<Request> queue_; // requests waiting for a free connection
+    map<Http::Client *, Request> active_; // requests in flight by client
+    vector<Http::Client *> idle_; // clients free to send the next request
+    map<Http::Client *, Wt::Signals::connection> streams_; // body data connections of streamed requests
+    map<string, Coalesced> latest_; // coalesced light commands by url
+};
+
+#endif //BRIDGECLIENT_H
@@ -0,0 +1,54 @@
+#ifndef BRIDGEPARSER_H
+#define BRIDGEPARSER_H
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include "BridgeState.h"
+
+using namespace std;
+using namespace Wt;
+
+class BridgeParser {
+
+public:
+    BridgeParser(BridgeState::Resource resource = BridgeState::AllResources);
+
+    virtual ~BridgeParser();
+
+    void feed(const string &data);
+    shared_ptr<BridgeState> finish();
+
+    //GETTERS
+    size_t getFingerprint() {return fingerprint_;}
+    size_t getSize() {return size_;}
+    BridgeState::Resource getResource() {return resource_;}
+
+    static const size_t MAX_ENTRY_SIZE = 65536; // largest light, group, schedule or config object kept in bytes
+
+private:
+    void read(char c);
+    void endKey();
+    void endEntry();
+
+    shared_ptr<BridgeState> state_; // state being filled
+    BridgeState::Resource resource_; // resource the body holds, AllResources for /api/<username>
+    size_t base_; // nesting depth of the resource objects, 1 for the whole bridge and 0 for one resource
+    string containers_; // '{' or '[' of every open object and array
+    BridgeState::Resource section_; // resource being read, AllResources while in a skipped member
+    string key_; // last key read above the entries
+    string entry_; // raw text of the entry being read
+    size_t entryDepth_; // nesting depth the entry started at
+    bool inString_; // inside a string
+    bool escape_; // last character was a backslash
+    bool expectKey_; // the next string is a key
+    bool keepKey_; // the string being read is a key above the entries
+    bool capturing_; // copying the current entry into entry_
+    bool oversized_; // the current entry went over MAX_ENTRY_SIZE
+    bool done_; // the top level object was closed
+    bool failed_; // the body is not a bridge object
+    size_t fingerprint_; // FNV-1a hash of every byte read
+    size_t size_; // bytes read
+};
+
+#endif //BRIDGEPARSER_H
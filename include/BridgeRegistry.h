@@ -0,0 +1,89 @@
+#ifndef BRIDGEREGISTRY_H
+#define BRIDGEREGISTRY_H
+
+#include <Wt/Http/Client>
+#include <Wt/Http/Message>
+#include <boost/function.hpp>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "BridgeState.h"
+#include "BridgeParser.h"
+
+using namespace std;
+using namespace Wt;
+
+class BridgeRegistry {
+
+public:
+    typedef boost::function<void (shared_ptr<BridgeState>)> Listener;
+
+    static BridgeRegistry *instance();
+
+    int subscribe(const string &ip, const string &port, const string &username,
+                  const string &sessionId, const Listener &listener,
+                  shared_ptr<BridgeState> seed = shared_ptr<BridgeState>());
+    void unsubscribe(int id);
+    void refresh(const string &bridge);
+    void touch(const string &bridge);
+
+    shared_ptr<BridgeState> getPolled(const string &bridge);
+    shared_ptr<BridgeState> setState(const string &ip, const string &port, const string &username, BridgeParser &parser);
+    shared_ptr<BridgeState> applyResponse(const string &bridge, int id, const string &resource,
+                                          const string &request, const string &response);
+
+    static string bridgeKey(const string &ip, const string &port, const string &username);
+
+    static const int FAST_POLL_INTERVAL = 2000; // milliseconds between polls while someone uses the bridge
+    static const int SLOW_POLL_INTERVAL = 30000; // milliseconds between polls of an idle bridge
+    static const int ACTIVE_PERIOD = 60000; // milliseconds a bridge counts as in use after the last command
+
+private:
+    BridgeRegistry();
+
+    typedef chrono::steady_clock Clock;
+
+    struct Subscriber {
+        string sessionId; // session the listener runs in
+        Listener listener;
+    };
+
+    struct Entry {
+        Entry() : version(0), pollVersion(0), client(0), polling(false), timerArmed(false) {}
+        string url; // http://ip:port/api/username
+        shared_ptr<BridgeState> state; // latest snapshot, never changed once published
+        long version; // bumped whenever a session changes state, polls sent before are stale
+        long pollVersion; // version when the poll request in flight was sent
+        map<int, size_t> fingerprints; // hash of the last fetched body by resource, unchanged bodies are not published
+        deque<BridgeState::Resource> pollQueue; // loaded resources still to fetch in the current poll
+        shared_ptr<BridgeParser> parser; // reads the body of the poll in flight
+        Clock::time_point lastActivity; // last command or subscription, picks the poll interval
+        map<int, Subscriber> subscribers; // sessions watching the bridge by subscription id
+        Http::Client *client; // client of the poll loop, outside of any session
+        bool polling; // a poll is waiting or in flight
+        bool timerArmed; // the next poll is scheduled
+    };
+
+    Entry &getEntry(const string &ip, const string &port, const string &username);
+    void poll(const string &bridge);
+    void pollNext(const string &bridge);
+    void armTimer(Entry &entry, const string &bridge);
+    void pollTimer(const string &bridge);
+    void sendPoll(const string &bridge);
+    void pollData(const string &bridge, const string &data);
+    void handlePoll(const string &bridge, boost::system::error_code err, const Http::Message &response);
+    void publish(Entry &entry, int except);
+    void release(const string &bridge);
+    static void deleteClient(Http::Client *client);
+    void deliver(int id, shared_ptr<BridgeState> state);
+
+    mutex mutex_; // guards entries_ and subscriptions_
+    map<string, Entry> entries_; // bridges by ip:port:username
+    map<int, string> subscriptions_; // bridge key by subscription id
+    int nextId_; // id of the next subscription
+};
+
+#endif //BRIDGEREGISTRY_H
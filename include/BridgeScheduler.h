@@ -0,0 +1,100 @@
+#ifndef BRIDGESCHEDULER_H
+#define BRIDGESCHEDULER_H
+
+#include <boost/function.hpp>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class BridgeScheduler {
+
+public:
+    // order in which waiting commands are let through
+    enum Priority {
+        Interactive = 0, // commands made from the lights/groups pages
+        Bulk = 1, // schedule creation and edits
+        Background = 2, // periodic and manual bridge refreshes
+        PriorityCount = 3
+    };
+
+    // rate budget a command is charged against
+    enum Budget {
+        Commands = 0, // light commands and every other request
+        Groups = 1, // group commands, which the bridge fans out to every light of the group
+        BudgetCount = 2
+    };
+
+    // queue statistics of one bridge
+    struct Stats {
+        int queued[PriorityCount]; // commands waiting by priority
+        long granted; // commands let through since startup
+        double averageWait; // average wait of granted commands in milliseconds
+        double maxWait; // longest wait of a granted command in milliseconds
+    };
+
+    static BridgeScheduler *instance();
+
+    void schedule(const string &bridge, Budget budget, Priority priority,
+                  const string &sessionId, const boost::function<void ()> &start, const void *owner = 0);
+    void cancel(const void *owner);
+    Stats getStats(const string &bridge);
+
+    static const int COMMAND_RATE = 10; // commands per second a bridge handles
+    static const int GROUP_RATE = 1; // group commands per second a bridge handles
+    static const int QUEUE_LIMIT = 100; // bridge queues kept before idle ones are dropped
+
+private:
+    BridgeScheduler();
+
+    typedef chrono::steady_clock Clock;
+
+    struct TokenBucket {
+        double tokens; // commands that may be sent now
+        double rate; // tokens added per second
+        double capacity; // largest burst
+        Clock::time_point refilled; // last time tokens were added
+    };
+
+    struct Waiting {
+        Budget budget;
+        string sessionId; // session that sends the command, empty outside of a session
+        boost::function<void ()> start; // runs in the session once the command may be sent
+        Clock::time_point queued; // when the command started waiting
+        const void *owner; // object start belongs to, its commands are dropped when it cancels
+    };
+
+    // command let through and posted to its session, not started yet
+    struct Granted {
+        string bridge; // bridge key the token was taken from
+        Waiting waiting;
+    };
+
+    struct BridgeQueue {
+        TokenBucket buckets[BudgetCount];
+        deque<Waiting> waiting[PriorityCount];
+        bool timerArmed; // a run is scheduled for when the next token is due
+        long granted;
+        double totalWait;
+        double maxWait;
+    };
+
+    BridgeQueue &getQueue(const string &bridge);
+    void run(const string &bridge);
+    void wake(const string &bridge);
+    void deliver(long ticket);
+    void drop(long ticket);
+    void prune(Clock::time_point now);
+    static void refill(TokenBucket &bucket, Clock::time_point now);
+
+    mutex mutex_; // guards bridges_, sessions of every thread schedule through here
+    map<string, BridgeQueue> bridges_; // queues by bridge ip:port:username
+    map<long, Granted> granted_; // posted commands by ticket, removed when started or cancelled
+    long nextTicket_; // ticket of the next posted command
+};
+
+#endif //BRIDGESCHEDULER_H
@@ -13,6 +13,8 @@
 #include <Wt/WIntValidator>
 #include <Wt/WRegExpValidator>
 #include "WelcomeScreen.h"
+#include "BridgeClient.h"
+#include "BridgeRegistry.h"
 class BridgeScreenWidget: public Wt::WContainerWidget
 {
 public:
@@ -59,15 +61,18 @@ private:
     void registerBridge();
     void registerBridgeHttp(boost::system::error_code err, const Wt::Http::Message &response);
 
-    void viewBridge(int pos);
-    void viewBridgeHttp(int pos, boost::system::error_code err, const Wt::Http::Message &response);
+    void viewBridge(Bridge bridge);
+    void viewBridgeHttp(Bridge bridge, shared_ptr<BridgeParser> parser, boost::system::error_code err, const Wt::Http::Message &response);
+    void showBridge(const Bridge &bridge);
 
-    void editBridge(int pos);
-    void shareBridgeDialog(int pos);
-    void shareBridge(int pos);
-    void updateBridge(int pos);
-    void updateBridgeHttp(int pos, boost::system::error_code err, const Wt::Http::Message &response);
-    void removeBridge(int pos);
+    void editBridge(Bridge bridge);
+    void shareBridgeDialog(Bridge bridge);
+    void shareBridge(Bridge bridge);
+    void updateBridge(Bridge bridge);
+    void updateBridgeHttp(Bridge old, string name, string location, string ip, string port, string username,
+                          boost::system::error_code err, const Wt::Http::Message &response);
+    void removeBridge(Bridge bridge);
+    void closeDialog(Wt::WDialog *dialog);
 };
 
 #endif //BRIDGE_SCREEN_WIDGET_H
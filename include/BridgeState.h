@@ -0,0 +1,81 @@
+#ifndef BRIDGESTATE_H
+#define BRIDGESTATE_H
+
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <Wt/Json/Value>
+#include <Wt/Json/Object>
+#include <Wt/Json/Parser>
+#include <Wt/Json/Array>
+#include "Light.h"
+#include "Group.h"
+#include "Schedule.h"
+
+using namespace std;
+using namespace Wt;
+
+class BridgeState {
+
+public:
+    // parts of a Bridge fetched on their own from /api/<username>/<resource>
+    enum Resource {Lights = 0, Groups = 1, Schedules = 2, Config = 3, AllResources = 4};
+
+    BridgeState();
+
+    virtual ~BridgeState();
+
+    bool parse(const string &json);
+    void merge(const BridgeState &from);
+    bool applyResponse(const string &resource, const string &request, const string &response);
+
+    //GETTERS
+    map<int, Light> &getLights() {return lights_;}
+    map<int, Group> &getGroups() {return groups_;}
+    map<int, Schedule> &getSchedules() {return schedules_;}
+    Light *getLight(int num);
+    Group *getGroup(int num);
+    Schedule *getSchedule(int num);
+    int getNumLights() {return lights_.size();}
+    int getNumGroups() {return groups_.size();}
+    int getNumSchedules() {return schedules_.size();}
+
+    string getName() {return name_;}
+    string getModelid() {return modelid_;}
+    string getSwversion() {return swversion_;}
+    string getApiversion() {return apiversion_;}
+    string getMac() {return mac_;}
+    bool isLoaded(Resource resource) {return loaded_[resource];}
+    bool isFresh(Resource resource, int maxAge);
+
+    static int parseKey(const string &key);
+    static string resourcePath(Resource resource);
+
+private:
+    friend class BridgeParser; // fills the state while the body is streamed in
+
+    bool applySuccess(const string &path, const Json::Value &value);
+    bool applyLightState(Light *light, const string &attr, const Json::Value &value);
+    bool applyGroupAction(Group *group, const string &attr, const Json::Value &value);
+    bool applyCreated(const string &resource, const string &id, const Json::Object &data);
+    bool applyDeleted(const string &path);
+    static vector<string> splitPath(const string &path);
+
+    map<int, Light> lights_; // lights ordered by light number
+    map<int, Group> groups_; // groups ordered by group number
+    map<int, Schedule> schedules_; // schedules ordered by schedule number
+
+    // bridge config
+    string name_; // name of the bridge
+    string modelid_; // bridge model
+    string swversion_; // bridge software version
+    string apiversion_; // Hue API version
+    string mac_; // bridge MAC address
+
+    bool loaded_[AllResources]; // resources that have been fetched
+    chrono::steady_clock::time_point fetched_[AllResources]; // when each resource was last fetched
+};
+
+#endif //BRIDGESTATE_H
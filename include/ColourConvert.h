@@ -1,6 +1,9 @@
 #ifndef COLOURCONVERT_H
 #define COLOURCONVERT_H
 
+#include <stddef.h>
+#include <string>
+
 // structure with X and Y components of a colour and brightness value
 struct xy {
     float x;
@@ -16,18 +19,60 @@ struct rgb {
     float brightness;
 };
 
+// structure with hue, saturation and brightness components of a colour in the ranges the lights use
+struct hsv {
+    float hue;
+    float sat;
+    float bri;
+};
+
+// corners of the triangle of xy colours a light can show
+struct gamut {
+    float red[2];
+    float green[2];
+    float blue[2];
+};
+
 
 class ColourConvert
 {
     //static public methods
     public:
-        static struct xy *rgb2xy(float red, float green, float blue);
-        static struct rgb *xy2rgb(float x, float y, float brightness);
-        static struct rgb *hsv2rgb(float hue, float sat, float bri);
+        static struct xy rgb2xy(float red, float green, float blue);
+        static struct rgb xy2rgb(float x, float y, float brightness);
+        static struct rgb hsv2rgb(float hue, float sat, float bri);
+
+        // batch conversions of count colours from in to out, for scenes and gradients across many lights
+        static void rgb2xyBatch(const struct rgb *in, struct xy *out, size_t count);
+        static void xy2rgbBatch(const struct xy *in, struct rgb *out, size_t count);
+        static void hsv2rgbBatch(const struct hsv *in, struct rgb *out, size_t count);
+
+        // gamut of a light model and conversion to the closest colour it can show
+        static const struct gamut &gamutFor(const std::string &modelid);
+        static struct xy clampToGamut(struct xy colour, const struct gamut &lightGamut);
+        static struct xy rgb2xy(float red, float green, float blue, const struct gamut &lightGamut);
+
+        static const struct gamut GAMUT_A; // early LivingColors and LightStrips
+        static const struct gamut GAMUT_B; // first generation Hue bulbs
+        static const struct gamut GAMUT_C; // later Hue bulbs and LightStrips plus
+        static const struct gamut GAMUT_DEFAULT; // whole xy plane, for unknown models and groups of mixed models
+
+        // colour temperature in mired, read from tables over the range the lights support
+        static struct rgb ct2rgb(float ct, float bri);
+        static struct xy ct2xy(float ct, float bri);
+        static float xy2ct(float x, float y);
+
+        static const int CT_MIN = 153; // coolest colour temperature of the lights in mired, 6500 K
+        static const int CT_MAX = 500; // warmest colour temperature of the lights in mired, 2000 K
+
+        static const int GAMMA_ENCODE_STEPS = 4096; // segments of the interpolated linear to sRGB table
+        static constexpr float GAMMA_TOLERANCE = 0.01f; // largest difference from the pow() result on the 0-255 scale
 
     protected:
 
     private:
+        static float gammaDecode(float c);
+        static float gammaEncode(float c);
 };
 
 #endif // COLOURCONVERT_H
@@ -12,12 +12,11 @@ class CreateAccountWidget: public Wt::WContainerWidget
 {
 public:
     CreateAccountWidget(Wt::WContainerWidget *parent = 0,
-                        Account *account = 0,
                         WelcomeScreen *main = 0);
 
     void update();
 private:
-    void writeUserInfo(std::string username, std::string password, std::string first, std::string last);
+    bool writeUserInfo(std::string username, std::string hashedPassword, std::string first, std::string last);
     Wt::WLineEdit *username_; // account name text box
     Wt::WLineEdit *firstName_;
     Wt::WLineEdit *lastName_;
@@ -33,12 +32,12 @@ private:
     Wt::WValidator *inputNotEmpty_; // empty input validator
 
     WelcomeScreen *parent_;
-    Account *account_;
 
     void submit();
     bool validatePassword();
     bool validateInputFields();
     bool checkNewUserid(std::string userid);
+    void passwordHashed(std::string username, std::string firstName, std::string lastName, std::string hashed);
 };
 
 #endif //CREATE_ACCOUNT_WIDGET_H
@@ -11,6 +11,10 @@
 #include <Wt/Json/Object>
 #include <Wt/Json/Parser>
 #include <Wt/Json/Array>
+#include <boost/lexical_cast.hpp>
+#include <stdint.h>
+#include <stdlib.h>
+#include "HueTypes.h"
 
 using namespace std;
 using namespace Wt;
@@ -18,62 +22,69 @@ using namespace Wt;
 class Group {
 
 public:
-    Group(WString groupNum, Json::Object groupData);
+    Group(WString groupNum, const Json::Object &groupData);
 
     virtual ~Group();
 
     //GETTERS
-    WString getGroupnum() {return groupnum_;}
-    WString getName() {return name_;}
-    WString getAlert() {return alert_;}
-    int getBri() {return bri_;}
-    WString getColormode() {return colormode_;}
-    int getCt() {return ct_;}
-    WString getEffect() {return effect_;}
-    int getHue() {return hue_;}
-    bool getOn() {return on_;}
-    bool getReachable() {return reachable_;}
-    int getSat() {return sat_;}
-    double getX() {return xy_[0];}
-    double getY() {return xy_[1];}
-    vector<WString> getLights() {return lights_;}
+    int getNum() {return num_;}
+    WString getGroupnum() {return WString::fromUTF8(boost::lexical_cast<string>(num_));}
+    WString getName() {return WString::fromUTF8(name_);}
+    WString getAlert() {return WString::fromUTF8(HueTypes::alertName((AlertMode)alert_));}
+    int getBri() {return flags_ & HAS_BRI ? bri_ : -1;}
+    WString getColormode() {return WString::fromUTF8(HueTypes::colorModeName((ColorMode)colormode_));}
+    int getCt() {return flags_ & HAS_CT ? ct_ : -1;}
+    WString getEffect() {return WString::fromUTF8(HueTypes::effectName((EffectMode)effect_));}
+    int getHue() {return flags_ & HAS_HUE ? hue_ : -1;}
+    bool getOn() {return flags_ & ON;}
+    bool getReachable() {return flags_ & REACHABLE;}
+    int getSat() {return flags_ & HAS_SAT ? sat_ : -1;}
+    double getX() {return flags_ & HAS_XY ? xy_[0] : -1.0;}
+    double getY() {return flags_ & HAS_XY ? xy_[1] : -1.0;}
+    const vector<uint16_t> &getLights() {return lights_;}
     int getNumLights() {return lights_.size();}
     int getTransition() {return transitiontime_;}
 
     //SETTERS
-    void setGroupnum(WString groupnum) {groupnum_ = groupnum;}
-    void setName(WString name) {name_ = name;}
-    void setAlert(WString alert) {alert_ = alert;}
-    void setBri(int bri) {bri_ = bri;}
-    void setColormode(WString colormode) {colormode_ = colormode;}
-    void setCt(int ct) {ct_ = ct;}
-    void setEffect(WString effect) {effect_ = effect;}
-    void setHue(int hue) {hue_ = hue;}
-    void setOn(bool on) {on_ = on;}
-    void setReachable(bool reachable) {reachable_ = reachable;}
-    void setSat(int sat) {sat_ = sat;}
-    void setX(double x) {xy_[0] = x;}
-    void setY(double y) {xy_[1] = y;}
-    void addLight(WString lightNum) {lights_.push_back(lightNum);}
+    void setGroupnum(WString groupnum) {num_ = atoi(groupnum.toUTF8().c_str());}
+    void setName(WString name) {name_ = name.toUTF8();}
+    void setAlert(WString alert) {alert_ = HueTypes::parseAlert(alert.toUTF8());}
+    void setBri(int bri) {setField(HAS_BRI, bri); bri_ = bri;}
+    void setColormode(WString colormode) {colormode_ = HueTypes::parseColorMode(colormode.toUTF8());}
+    void setCt(int ct) {setField(HAS_CT, ct); ct_ = ct;}
+    void setEffect(WString effect) {effect_ = HueTypes::parseEffect(effect.toUTF8());}
+    void setHue(int hue) {setField(HAS_HUE, hue); hue_ = hue;}
+    void setOn(bool on) {setFlag(ON, on);}
+    void setReachable(bool reachable) {setFlag(REACHABLE, reachable);}
+    void setSat(int sat) {setField(HAS_SAT, sat); sat_ = sat;}
+    void setX(double x) {setField(HAS_XY, x); xy_[0] = x;}
+    void setY(double y) {setField(HAS_XY, y); xy_[1] = y;}
+    void addLight(int lightNum) {lights_.push_back(lightNum);}
+    void clearLights() {lights_.clear();}
     void setTransition(int transitiontime) {transitiontime_ = transitiontime;}
 
-    void toggleOnOff() {on_ = !on_;}
+    void toggleOnOff() {setOn(!getOn());}
 
 private:
-    WString groupnum_; // group number
-    WString name_; // group name
-    WString alert_; // alert mode
-    int bri_; // brightness
-    WString colormode_; // color mode
-    int ct_; // CT
-    WString effect_; // effect
-    int hue_; // hue value
-    bool on_; // group on/off switch
-    bool reachable_; // reachable
-    int sat_; // saturation value
-    double xy_[2]; // X and Y values
-    vector<WString> lights_; // vector of lights in the group
-    int transitiontime_; // transition time of the group
+    // bits of flags_
+    enum Flags {HAS_BRI = 1, HAS_CT = 2, HAS_HUE = 4, HAS_SAT = 8, HAS_XY = 16, ON = 32, REACHABLE = 64};
+
+    void setFlag(uint8_t flag, bool set) {flags_ = set ? flags_ | flag : flags_ & ~flag;}
+    void setField(uint8_t flag, double value) {setFlag(flag, value >= 0);} // -1 marks a value the bridge did not report
+
+    string name_; // group name
+    vector<uint16_t> lights_; // numbers of the lights in the group
+    float xy_[2]; // X and Y values
+    uint16_t num_; // group number
+    uint16_t hue_; // hue value
+    uint16_t ct_; // CT
+    uint16_t transitiontime_; // transition time of the group
+    uint8_t bri_; // brightness
+    uint8_t sat_; // saturation value
+    uint8_t colormode_; // color mode, a ColorMode
+    uint8_t alert_; // alert mode, an AlertMode
+    uint8_t effect_; // effect, an EffectMode
+    uint8_t flags_; // on, reachable and which values were reported
 };
 
 #endif //GROUP_H
@@ -22,6 +22,23 @@ class Hash
     public:
         static std::string sha256_hash(const std::string str);
 
+        static std::string hashPassword(const std::string &password);
+        static bool verifyPassword(const std::string &password, const std::string &stored);
+        static bool needsRehash(const std::string &stored);
+
+        static void setIterations(int rounds);
+        static int getIterations();
+
+        static const int DEFAULT_ITERATIONS = 100000; // PBKDF2 rounds of new hashes
+        static const int MIN_ITERATIONS = 1000; // fewest rounds setIterations accepts
+        static const int SALT_LENGTH = 16; // bytes of random salt per password
+        static const int KEY_LENGTH = 32; // bytes of derived key
+
+    // static private methods
+    private:
+        static std::string toHex(const unsigned char *bytes, int length);
+        static bool fromHex(const std::string &hex, std::string &bytes);
+        static std::string pbkdf2(const std::string &password, const std::string &salt, int rounds);
 };
 
 #endif // HASH_H
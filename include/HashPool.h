@@ -0,0 +1,42 @@
+#ifndef HASHPOOL_H
+#define HASHPOOL_H
+
+#include <boost/function.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class HashPool {
+
+public:
+    static HashPool *instance();
+
+    bool hash(const string &password, const string &sessionId,
+              const boost::function<void (string)> &done);
+    bool verify(const string &password, const string &stored, const string &sessionId,
+                const boost::function<void (bool, string)> &done);
+
+    static const int THREADS = 2; // password hashes computed at once
+    static const int QUEUE_LIMIT = 32; // waiting jobs before new ones are refused
+
+private:
+    HashPool();
+    ~HashPool();
+
+    bool submit(const boost::function<void ()> &job);
+    void work();
+    static void deliver(const string &sessionId, const boost::function<void ()> &result);
+
+    mutex mutex_; // guards jobs_ and stopping_
+    condition_variable ready_; // signalled when a job is queued or the pool stops
+    deque<boost::function<void ()> > jobs_; // hashes waiting for a worker
+    vector<thread> workers_;
+    bool stopping_;
+};
+
+#endif //HASHPOOL_H
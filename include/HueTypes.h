@@ -0,0 +1,35 @@
+#ifndef HUETYPES_H
+#define HUETYPES_H
+
+#include <stdint.h>
+#include <string>
+
+using namespace std;
+
+// colour mode of a light or group, "null" when the bridge did not report one
+enum ColorMode : uint8_t {ColorModeNull = 0, ColorModeHS, ColorModeXY, ColorModeCT};
+
+// alert mode of a light or group, "null" when the bridge did not report one
+enum AlertMode : uint8_t {AlertNull = 0, AlertNone, AlertSelect, AlertLSelect};
+
+// dynamic effect of a light or group, "null" when the bridge did not report one
+enum EffectMode : uint8_t {EffectNull = 0, EffectNone, EffectColorloop};
+
+class HueTypes
+{
+    //static public methods
+    public:
+        static ColorMode parseColorMode(const string &colormode);
+        static AlertMode parseAlert(const string &alert);
+        static EffectMode parseEffect(const string &effect);
+        static string colorModeName(ColorMode colormode);
+        static string alertName(AlertMode alert);
+        static string effectName(EffectMode effect);
+
+        static const string *intern(const string &value);
+
+    private:
+        HueTypes() {}
+};
+
+#endif //HUETYPES_H
@@ -16,12 +16,15 @@
 #include <Wt/WGroupBox>
 #include <Wt/WRadioButton>
 #include <Wt/WCheckBox>
+#include <Wt/WSplitButton>
 #include "WelcomeScreen.h"
 #include "Bridge.h"
 #include "Light.h"
 #include "Group.h"
 #include "Schedule.h"
 #include "ColourConvert.h"
+#include "BridgeClient.h"
+#include "BridgeRegistry.h"
 
 class LightManagementWidget: public Wt::WContainerWidget
 {
@@ -30,10 +33,16 @@ public:
                         Bridge *bridge = 0,
                         WelcomeScreen *main = 0);
 
+    virtual ~LightManagementWidget();
+
     void update();
+    void stopWatching();
+
+    static const int FRESH_PERIOD = 30000; // milliseconds a loaded page is shown without fetching it again while live updates are off
 private:
     WelcomeScreen *parent_; // parent widget
     Bridge *bridge_; // current bridge
+    BridgeClient *client_; // shared HTTP client service of the current bridge
 
     Wt::WStackedWidget *lightManagementStack_; // main stack of the screen
 
@@ -46,6 +55,44 @@ private:
     Wt::WTable *groupsTable_; // groups table
     Wt::WTable *schedulesTable_; // schedules table
 
+    // widgets of a lights table row that change with the light
+    struct LightRow {
+        Wt::WTableRow *row;
+        Wt::WText *name;
+        Wt::WLineEdit *transition;
+        Wt::WSlider *brightness;
+        Wt::WPushButton *onButton;
+        Wt::WSplitButton *colourButton;
+    };
+    // widgets of a groups table row that change with the group
+    struct GroupRow {
+        Wt::WTableRow *row;
+        Wt::WText *name;
+        Wt::WLineEdit *transition;
+        vector<uint16_t> lights; // light numbers shown in the row
+    };
+    // widgets of a schedules table row that change with the schedule
+    struct ScheduleRow {
+        Wt::WTableRow *row;
+        Wt::WText *name;
+        Wt::WText *description;
+        Wt::WText *time;
+        vector<string> action; // action lines shown in the row
+    };
+    map<int, LightRow> lightRows_; // rendered lights table rows by light number
+    map<int, GroupRow> groupRows_; // rendered groups table rows by group number
+    map<int, ScheduleRow> scheduleRows_; // rendered schedules table rows by schedule number
+
+    int subscription_; // subscription to the shared state of the bridge, -1 while live updates are off
+    Wt::WCheckBox *liveUpdatesBox_; // turns live updates of the bridge on and off
+    Wt::WPushButton *refreshButton_; // manual refresh, shown while live updates are off
+
+    bool loading_[BridgeState::AllResources]; // resources being fetched
+
+    Wt::WText *pendingText_; // pending commands indicator
+    Wt::WText *statusText_; // result of the last failed command
+    int pending_; // commands sent and not answered yet
+
     // editRGBDialog function widgets
     Wt::WContainerWidget *rgbContainer_; //contains XY RGB slider
     Wt::WSlider *brightnessSlider_; // brightness value
@@ -54,6 +101,7 @@ private:
     Wt::WSlider *redSlider;
     Wt::WSlider *greenSlider;
     Wt::WSlider *blueSlider;
+    const struct gamut *previewGamut_; // gamut the RGB preview is clamped to
 
     // editHueSatDialog function widgets
     Wt::WContainerWidget *hueSatContainer_; //contains hue and sat sliders
@@ -62,6 +110,12 @@ private:
     Wt::WSlider *satSlider;
     Wt::WSlider *briSlider;
 
+    // editCtDialog function widgets
+    Wt::WContainerWidget *ctContainer_; // contains colour temperature and brightness sliders
+    Wt::WDialog *editCtDialog_; // edit colour temperature dialog
+    Wt::WSlider *ctSlider;
+    Wt::WSlider *ctBriSlider;
+
     // lights page widgets
     Wt::WLineEdit *editLightTransition; // transition value
     Wt::WIntValidator *intValidator; // text box validator
@@ -105,40 +159,63 @@ private:
     void viewLightsWidget();
     void viewGroupsWidget();
     void viewSchedulesWidget();
-    void editRGBDialog(Light *light);
-    void editHueSatDialog(Light *light);
+    void editRGBDialog(int num);
+    void editHueSatDialog(int num);
+    void editCtDialog(int num);
 
     void updateLightsTable();
-    void editLightDialog(Light *light);
-    void removeLight(Light *light);
-    void updateLightInfo(Light *light);
-    void updateLightBri(WSlider *slider_, Light *light);
-    void updateLightOn(WPushButton *button_, Light *light);
-    void updateLightXY(Light *light);
-    void updateLightHS(Light *light);
+    void insertLightRow(int num, Light *light, int index);
+    void updateLightRow(LightRow &row, Light *light);
+    int lightTransition(int num);
+    void editLightDialog(int num);
+    void removeLight(int num);
+    void updateLightInfo(int num);
+    void updateLightBri(WSlider *slider_, int num);
+    void updateLightOn(WPushButton *button_, int num);
+    void updateLightXY(int num);
+    void updateLightHS(int num);
+    void updateLightCt(int num);
 
     void updateGroupsTable();
+    void insertGroupRow(int num, Group *group, int index);
+    void updateGroupRow(GroupRow &row, Group *group);
+    int groupTransition(int num);
     void createGroupDialog();
-    void groupAdvancedDialog(Group *group);
-    void editGroupDialog(Group *group);
+    void groupAdvancedDialog(int num);
+    void editGroupDialog(int num);
     void createGroup();
-    void removeGroup(Group *group);
-    void updateGroupInfo(Group *group);
-    void groupUpdateAdvanced(Group *group);
+    void removeGroup(int num);
+    void updateGroupInfo(int num);
+    void groupUpdateAdvanced(int num);
 
     void updateSchedulesTable();
+    vector<string> scheduleAction(Schedule *schedule);
+    void showScheduleAction(ScheduleRow &row);
+    void insertScheduleRow(int num, Schedule *schedule, int index);
+    void updateScheduleRow(ScheduleRow &row, Schedule *schedule);
     void createScheduleDialog();
     void createSchedule();
-    void editScheduleDialog(Schedule *schedule);
-    void updateScheduleInfo(Schedule *schedule);
-    void removeSchedule(Schedule *schedule);
+    void editScheduleDialog(int num);
+    void updateScheduleInfo(int num);
+    void removeSchedule(int num);
 
     void deleteRequest(string url);
     void putRequest(string url, string json);
+    void putLightState(string url, const Json::Object &state);
     void postRequest(string url, string json);
-    void handlePutHttp(boost::system::error_code err, const Wt::Http::Message &response);
+    void commandSent();
+    void closeDialog(Wt::WDialog *dialog);
+    void showRGBPreview();
+    void showHueSatPreview();
+    void showCtPreview();
+    void showPending();
+    void handlePutHttp(string url, string json, boost::system::error_code err, const Wt::Http::Message &response);
     void refreshBridge();
-    void refreshBridgeHttp(boost::system::error_code err, const Wt::Http::Message &response);
+    void loadResource(BridgeState::Resource resource, bool force = false);
+    void loadResourceHttp(shared_ptr<BridgeParser> parser, boost::system::error_code err, const Wt::Http::Message &response);
+    void setLiveUpdates();
+    void subscribe();
+    void stateChanged(shared_ptr<BridgeState> state);
 };
 
 
@@ -0,0 +1,43 @@
+#ifndef LOGINTHROTTLE_H
+#define LOGINTHROTTLE_H
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+class LoginThrottle {
+
+public:
+    static LoginThrottle *instance();
+
+    bool allow(const string &address, const string &account);
+
+    static const int ADDRESS_BURST = 10; // attempts a client address may make at once
+    static const int ADDRESS_PERIOD = 6; // seconds to earn back one attempt of an address
+    static const int ACCOUNT_BURST = 5; // attempts on one account that may be made at once
+    static const int ACCOUNT_PERIOD = 30; // seconds to earn back one attempt on an account
+    static const int BUCKET_LIMIT = 10000; // buckets kept before full ones are dropped
+
+private:
+    LoginThrottle();
+
+    typedef chrono::steady_clock Clock;
+
+    struct TokenBucket {
+        double tokens; // attempts that may be made now
+        Clock::time_point refilled; // last time tokens were added
+    };
+
+    static double refill(unordered_map<string, TokenBucket> &buckets, const string &key,
+                         int burst, int period, Clock::time_point now);
+    static void prune(unordered_map<string, TokenBucket> &buckets, int burst, int period, Clock::time_point now);
+
+    mutex mutex_; // guards the buckets, sessions of every thread log in through here
+    unordered_map<string, TokenBucket> addresses_; // buckets by client address
+    unordered_map<string, TokenBucket> accounts_; // buckets by account email
+};
+
+#endif //LOGINTHROTTLE_H
@@ -11,7 +11,6 @@ class LoginWidget: public Wt::WContainerWidget
 {
 public:
     LoginWidget(Wt::WContainerWidget *parent = 0,
-                Account *account = 0,
                 WelcomeScreen *main = 0);
     void update();
 
@@ -25,10 +24,10 @@ private:
     Wt::WLengthValidator *passwordLengthValidator_;
     
     WelcomeScreen *parent_;
-    Account *account_;
 
     void submit();
     bool checkCredentials(std::string username, std::string password);
+    void credentialsChecked(std::string username, bool matched, std::string upgraded);
 };
 
 #endif //LOGIN_WIDGET_H
@@ -0,0 +1,28 @@
+#ifndef PROFILEPICTURE_H
+#define PROFILEPICTURE_H
+
+#include <string>
+
+using namespace std;
+
+class ProfilePicture {
+
+public:
+    static string store(const string &file);
+    static string url(const string &picture, int size);
+    static string path(const string &picture, int size);
+    static bool isThumbnail(const string &picture, int size);
+
+    static const char *DIRECTORY; // where thumbnails are kept, outside of the docroot
+    static const char *DEFAULT_PICTURE; // picture of accounts that did not upload one
+    static const char *RESOURCE_PATH; // path the thumbnails are served at
+
+    static const int SMALL = 50; // size of the avatar in the navigation bar
+    static const int LARGE = 100; // size of the picture on the profile page
+
+private:
+    static string defaultPicture();
+    static bool writeThumbnail(const string &file, int width, int height, int size, const string &path);
+};
+
+#endif //PROFILEPICTURE_H
@@ -0,0 +1,19 @@
+#ifndef PROFILEPICTURERESOURCE_H
+#define PROFILEPICTURERESOURCE_H
+
+#include <Wt/WResource>
+#include <Wt/Http/Request>
+#include <Wt/Http/Response>
+
+class ProfilePictureResource : public Wt::WResource {
+
+public:
+    ProfilePictureResource(Wt::WObject *parent = 0);
+    virtual ~ProfilePictureResource();
+
+    virtual void handleRequest(const Wt::Http::Request &request, Wt::Http::Response &response);
+
+    static const int MAX_AGE = 31536000; // seconds browsers may keep a thumbnail without asking
+};
+
+#endif //PROFILEPICTURERESOURCE_H
@@ -34,6 +34,7 @@ private:
     Wt::WFileUpload *picUpload_;
     Wt::WText *profilePicOutMessage_;
     bool fileTooLarge = false;
+    bool pictureUnreadable = false;
 
     Wt::WValidator *inputNotEmpty_;
     Wt::WLengthValidator *passwordLengthValidator_;
@@ -41,9 +42,11 @@ private:
     void updateFirstName();
     void updateLastName();
     void showPasswordDialog();
-    bool checkValidPassword(std::string pass);
     void updatePassword();
-    void uploadProfilePicture(std::string file);
+    void currentPasswordChecked(std::string newPassword, std::string confirmNewPassword, bool newPasswordValid, bool matched);
+    void passwordHashed(std::string hashed);
+    void closeDialog(Wt::WDialog *dialog);
+    bool uploadProfilePicture(std::string file);
 
 };
 
@@ -11,6 +11,9 @@
 #include <Wt/Json/Object>
 #include <Wt/Json/Parser>
 #include <Wt/Json/Array>
+#include <boost/lexical_cast.hpp>
+#include <stdint.h>
+#include "HueTypes.h"
 
 
 using namespace std;
@@ -19,34 +22,41 @@ using namespace Wt;
 class Schedule {
 
 public:
-    Schedule(WString scheduleNum, Json::Object scheduleData);
+    Schedule(WString scheduleNum, const Json::Object &scheduleData);
 
     virtual ~Schedule();
 
     //GETTERS
-    WString getSchedulenum() {return schedulenum_;}
-    WString getName() {return name_;}
-    WString getDescription() {return description_;}
-    WString getTime() {return time_;}
-    WString getAddress() {return address_;}
-    WString getMethod() {return method_;}
+    int getNum() {return num_;}
+    WString getSchedulenum() {return WString::fromUTF8(boost::lexical_cast<string>(num_));}
+    WString getName() {return WString::fromUTF8(name_);}
+    WString getDescription() {return WString::fromUTF8(description_);}
+    WString getTime() {return WString::fromUTF8(time_);}
+    WString getAddress() {return WString::fromUTF8(address_);}
+    WString getMethod() {return WString::fromUTF8(*method_);}
     int getBri() {return bri_;}
     int getTransition() {return transition_;}
     bool getOn() {return on_;}
     double getX() {return xy_[0];}
     double getY() {return xy_[1];}
 
+    //SETTERS
+    void setName(WString name) {name_ = name.toUTF8();}
+    void setDescription(WString description) {description_ = description.toUTF8();}
+    void setTime(WString time) {time_ = time.toUTF8();}
+    void setCommand(const Json::Object &command);
+
 private:
-    WString schedulenum_; // schedule number
-    WString name_; // name
-    WString description_; // description
-    WString time_; // time
-    WString address_; // address
-    WString method_; // method
-    int bri_; // brightness value
-    int transition_; // transition time
+    string name_; // name
+    string description_; // description
+    string time_; // time
+    string address_; // address
+    const string *method_; // method, interned
+    float xy_[2]; // X and Y color values
+    uint16_t num_; // schedule number
+    int16_t bri_; // brightness value, -1 if not set
+    uint16_t transition_; // transition time
     bool on_; // on/off toggle
-    vector<double> xy_; // X and Y color values
 };
 
 #endif //SCHEDULE_H
@@ -11,6 +11,8 @@
 #include <Wt/WPushButton>
 #include <string>
 #include <vector>
+#include <map>
+#include <memory>
 #include "Account.h"
 
 namespace Wt {
@@ -23,6 +25,7 @@ class CreateAccountWidget;
 class BridgeScreenWidget;
 class ProfileWidget;
 class LightManagementWidget;
+class BridgeClient;
 
 class WelcomeScreen : public Wt::WContainerWidget
 {
@@ -30,14 +33,17 @@ public:
     WelcomeScreen(Wt::WContainerWidget *parent = 0);
     void handleInternalPath(const std::string &internalPath);
 
-    Account getAccount() {return account_;};
-    void setAccount(Account account) {account_ = account;};
+    std::shared_ptr<Account> getAccount() {return account_;};
+
+    BridgeClient *getBridgeClient(std::string ip, std::string port);
 
     void connectBridge();
     void handleHttpResponse(boost::system::error_code err, const Wt::Http::Message &response);
 
     void updateProfileName();
-    void loginSuccess();
+    void updateProfilePicture();
+    bool loginSuccess(const std::string &email);
+    void setBridgeState(const std::string &key, std::shared_ptr<BridgeState> state);
 
 private:
     Wt::WNavigationBar *navBar_;
@@ -59,6 +65,9 @@ private:
     BridgeScreenWidget *bridgeScreen_; // bridge widget
     ProfileWidget *profileScreen_; // profile widget
     LightManagementWidget *lightManage_; // light management widget
+    std::map<std::string, BridgeClient *> bridgeClients_; // HTTP client service per bridge ip:port
+    std::map<std::string, std::shared_ptr<BridgeState> > bridgeStates_; // loaded state per bridge ip:port:username
+    std::unique_ptr<Bridge> viewedBridge_; // this session's copy of the bridge on the light management screen
 
     void loginScreen();
     void createAccountScreen();
@@ -66,7 +75,7 @@ private:
     void profileScreen();
     void lightManagementScreen(int index);
 
-    Account account_;
+    std::shared_ptr<Account> account_; // shared with the other sessions of the user once logged in
 };
 
 #endif //WELCOME_SCREEN_H
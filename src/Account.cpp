@@ -10,13 +10,16 @@
  *
  *              This class stores the profile of the user that has registered to the
  *              application. The hashed password is stored and not in plain text. The
- *              Account class manages writing to the serialized account file, editing
+ *              Account class manages writing to the account store, editing
  *              user details, and adding and removing Bridge objects that the user
- *              has registered to their account.
+ *              has registered to their account. One Account is shared by every session
+ *              of its user through the AccountRegistry, so its fields are guarded by a
+ *              lock and the bridge list is replaced instead of changed in place.
  */
 
 #include <string>
 #include "Account.h"
+#include "AccountStore.h"
 
 /**
  *   @brief  Account constructor
@@ -28,12 +31,52 @@
  *
  */
 Account::Account(string fn, string ln, string em, string pw) :
-firstName_(fn),
-lastName_(ln),
-email_(em),
-password_(pw),
-auth_(false){
-    bridges.reserve(15); //reserve initial 15 spaces which dynamically increases once surpassed
+firstName_(move(fn)),
+lastName_(move(ln)),
+email_(move(em)),
+password_(move(pw)),
+auth_(false),
+bridges(make_shared<vector<Bridge> >()){
+}
+
+/**
+ *   @brief  Account copy constructor, the copy shares the bridge list until either changes it
+ *
+ *   @param  &other is the account to copy
+ *
+ */
+Account::Account(const Account &other) {
+    lock_guard<mutex> lock(other.mutex_);
+    firstName_ = other.firstName_;
+    lastName_ = other.lastName_;
+    email_ = other.email_;
+    password_ = other.password_;
+    picture_ = other.picture_;
+    auth_ = other.auth_;
+    bridges = other.bridges;
+}
+
+/**
+ *   @brief  Account assignment, the copy shares the bridge list until either changes it
+ *
+ *   @param  &other is the account to copy
+ *
+ *   @return Account& this account
+ *
+ */
+Account &Account::operator=(const Account &other) {
+    if(this == &other) return *this;
+
+    Account copy(other);
+    lock_guard<mutex> lock(mutex_);
+    firstName_ = move(copy.firstName_);
+    lastName_ = move(copy.lastName_);
+    email_ = move(copy.email_);
+    password_ = move(copy.password_);
+    picture_ = move(copy.picture_);
+    auth_ = copy.auth_;
+    bridges = move(copy.bridges);
+    return *this;
 }
 
 /**
@@ -44,41 +87,222 @@ Account::~Account() {
     
 }
 
+/**
+ *   @brief  Returns the first name of the user
+ *
+ *   @return string the first name
+ *
+ */
+string Account::getFirstName() const {
+    lock_guard<mutex> lock(mutex_);
+    return firstName_;
+}
+
+/**
+ *   @brief  Returns the last name of the user
+ *
+ *   @return string the last name
+ *
+ */
+string Account::getLastName() const {
+    lock_guard<mutex> lock(mutex_);
+    return lastName_;
+}
+
+/**
+ *   @brief  Returns the email of the user
+ *
+ *   @return string the email
+ *
+ */
+string Account::getEmail() const {
+    lock_guard<mutex> lock(mutex_);
+    return email_;
+}
+
+/**
+ *   @brief  Returns the hashed password of the user
+ *
+ *   @return string the hashed password
+ *
+ */
+string Account::getPassword() const {
+    lock_guard<mutex> lock(mutex_);
+    return password_;
+}
+
+/**
+ *   @brief  Returns the profile picture of the user
+ *
+ *   @return string the id of the picture, empty for the default picture
+ *
+ */
+string Account::getPicture() const {
+    lock_guard<mutex> lock(mutex_);
+    return picture_;
+}
+
+/**
+ *   @brief  Returns the logged in status of the account
+ *
+ *   @return bool true if the user logged in
+ *
+ */
+bool Account::isAuth() const {
+    lock_guard<mutex> lock(mutex_);
+    return auth_;
+}
+
+/**
+ *   @brief  Returns the Bridges of the user account. The list is never changed, edits of the
+ *           account replace it, so it can be read without copying while other sessions edit.
+ *
+ *   @return shared_ptr<const vector<Bridge> > the Bridges
+ *
+ */
+shared_ptr<const vector<Bridge> > Account::getBridges() const {
+    lock_guard<mutex> lock(mutex_);
+    return bridges;
+}
+
+/**
+ *   @brief  Returns the number of Bridges in the user account
+ *
+ *   @return int the number of Bridges
+ *
+ */
+int Account::getNumBridges() const {
+    lock_guard<mutex> lock(mutex_);
+    return bridges->size();
+}
+
+/**
+ *   @brief  Returns a copy of a Bridge in the user account
+ *
+ *   @param  index the position of the Bridge in the vector to retrieve (0 is first position)
+ *
+ *   @return Bridge object in user account
+ *
+ */
+Bridge Account::getBridgeAt(int index) const {
+    lock_guard<mutex> lock(mutex_);
+    return bridges->at(index);
+}
 
 /**
- *   @brief  Write Account object to the user account data file stored in application
+ *   @brief  Sets the first name of the user
+ *
+ *   @param  fn is the first name
  *
  *   @return void
  *
  */
-void Account::writeFile() {
-    
-    // creates credentials folder if one does not exist
-    const int dir_err = system("mkdir -p credentials");
-    if (-1 == dir_err)
-    {
-        cout << "ERROR - Could not create directory\n";
-        exit(1);
-    }
-    
-    ofstream writefile;
-    string file = "credentials/" + getEmail() +".txt";
-    
-    writefile.open(file.c_str());
-    
-    writefile << getPassword() << endl; // cryptographically hashed password
-    writefile << getFirstName() << endl;
-    writefile << getLastName() << endl;
-    
-    for(auto &bridge : getBridges()) { //loop through all bridges
-        writefile << bridge.getName() << ", "
-        << bridge.getLocation() << ", "
-        << bridge.getIP() << ", "
-        << bridge.getPort() << ", "
-        << bridge.getUsername() << "\n";
-    }
-    
-    writefile.close();
+void Account::setFirstName(string fn) {
+    lock_guard<mutex> lock(mutex_);
+    firstName_ = move(fn);
+}
+
+/**
+ *   @brief  Sets the last name of the user
+ *
+ *   @param  ln is the last name
+ *
+ *   @return void
+ *
+ */
+void Account::setLastName(string ln) {
+    lock_guard<mutex> lock(mutex_);
+    lastName_ = move(ln);
+}
+
+/**
+ *   @brief  Sets the email of the user
+ *
+ *   @param  em is the email
+ *
+ *   @return void
+ *
+ */
+void Account::setEmail(string em) {
+    lock_guard<mutex> lock(mutex_);
+    email_ = move(em);
+}
+
+/**
+ *   @brief  Sets the hashed password of the user
+ *
+ *   @param  pw is the hashed password
+ *
+ *   @return void
+ *
+ */
+void Account::setPassword(string pw) {
+    lock_guard<mutex> lock(mutex_);
+    password_ = move(pw);
+}
+
+/**
+ *   @brief  Sets the profile picture of the user
+ *
+ *   @param  pic is the id of the picture made by ProfilePicture::store
+ *
+ *   @return void
+ *
+ */
+void Account::setPicture(string pic) {
+    lock_guard<mutex> lock(mutex_);
+    picture_ = move(pic);
+}
+
+/**
+ *   @brief  Sets the logged in status of the account
+ *
+ *   @param  val is true if the user logged in
+ *
+ *   @return void
+ *
+ */
+void Account::setAuth(bool val) {
+    lock_guard<mutex> lock(mutex_);
+    auth_ = val;
+}
+
+/**
+ *   @brief  Edit the account through the account store of the application. The edit is applied
+ *           to the stored account, so edits made by other sessions meanwhile are kept, and the
+ *           account registry refreshes the account every session of the user holds with the
+ *           result. Returns without waiting for the write.
+ *
+ *   @param  &mutation is the edit, called with the stored account
+ *
+ *   @return bool false if the account is not in the store
+ *
+ */
+bool Account::update(const boost::function<void (Account &)> &mutation) {
+    string email = getEmail();
+    Account latest("", "", email, "");
+    return AccountStore::instance()->update(email, mutation, latest);
+}
+
+/**
+ *   @brief  Replace the names, password, picture and bridges of the account with those of a
+ *           newer stored copy, the logged in status is kept
+ *
+ *   @param  &stored is the stored copy of the account
+ *
+ *   @return void
+ *
+ */
+void Account::refresh(const Account &stored) {
+    if(this == &stored) return;
+
+    Account copy(stored);
+    lock_guard<mutex> lock(mutex_);
+    firstName_ = move(copy.firstName_);
+    lastName_ = move(copy.lastName_);
+    password_ = move(copy.password_);
+    picture_ = move(copy.picture_);
+    bridges = move(copy.bridges);
 }
 
 /**
@@ -90,7 +314,10 @@ void Account::writeFile() {
  *
  */
 void Account::addBridge(Bridge br) {
-    bridges.push_back(br);
+    lock_guard<mutex> lock(mutex_);
+    shared_ptr<vector<Bridge> > changed = make_shared<vector<Bridge> >(*bridges);
+    changed->push_back(move(br));
+    bridges = changed;
 }
 
 /**
@@ -107,20 +334,23 @@ void Account::addBridge(Bridge br) {
  */
 void Account::addBridge(string bname, string bloc, string bip,
                         string bport, string buser) {
-    Bridge *br = new Bridge(bname, bloc, bip, bport, buser);
-    bridges.push_back(*br);
+    addBridge(Bridge(move(bname), move(bloc), move(bip), move(bport), move(buser)));
 }
 
 /**
- *   @brief  Returns a pointer to a Bridge in the user account
+ *   @brief  Replace a Bridge in the user account
  *
- *   @param  index the position of the Bridge in the vector to retrieve (0 is first position)
+ *   @param  index the position of the Bridge in the vector to replace (0 is first position)
+ *   @param  br the new Bridge
  *
- *   @return pointer to Bridge object in user account
+ *   @return void
  *
  */
-Bridge* Account::getBridgeAt(int index) {
-    return &bridges.at(index);
+void Account::setBridgeAt(int index, Bridge br) {
+    lock_guard<mutex> lock(mutex_);
+    shared_ptr<vector<Bridge> > changed = make_shared<vector<Bridge> >(*bridges);
+    changed->at(index) = move(br);
+    bridges = changed;
 }
 
 /**
@@ -132,5 +362,29 @@ Bridge* Account::getBridgeAt(int index) {
  *
  */
 void Account::removeBridgeAt(int index) {
-    bridges.erase(bridges.begin() + index);
+    lock_guard<mutex> lock(mutex_);
+    shared_ptr<vector<Bridge> > changed = make_shared<vector<Bridge> >(*bridges);
+    changed->erase(changed->begin() + index);
+    bridges = changed;
+}
+
+/**
+ *   @brief  Find a Bridge in the user account by its name, location, address and username
+ *
+ *   @param  bridge the Bridge to look for
+ *
+ *   @return position of the first matching Bridge, -1 if there is none
+ *
+ */
+int Account::findBridge(const Bridge &bridge) const {
+    shared_ptr<const vector<Bridge> > current = getBridges();
+    for(int i = 0; i < (int)current->size(); i++) {
+        const Bridge &candidate = (*current)[i];
+        if(candidate.getName() == bridge.getName() && candidate.getLocation() == bridge.getLocation() &&
+           candidate.getIP() == bridge.getIP() && candidate.getPort() == bridge.getPort() &&
+           candidate.getUsername() == bridge.getUsername()) {
+            return i;
+        }
+    }
+    return -1;
 }
@@ -0,0 +1,114 @@
+/**
+ *  @file       AccountRegistry.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application accounts of logged in users
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class hands every session of a user the same Account, so two tabs of
+ *              one user share one account and one bridge list instead of each keeping a
+ *              copy. The registry only holds weak references: an account is loaded from the
+ *              account store when its first session logs in and released with its last.
+ *              Every edit stored for an account, whichever session or user made it, is
+ *              passed on to the account its sessions hold.
+ */
+
+#include "AccountRegistry.h"
+#include "AccountStore.h"
+
+/**
+ *   @brief  Returns the registry shared by every session of the process
+ *
+ *   @return  AccountRegistry* the registry
+ */
+AccountRegistry *AccountRegistry::instance() {
+    static AccountRegistry registry;
+    return &registry;
+}
+
+/**
+ *   @brief  AccountRegistry constructor
+ *
+ */
+AccountRegistry::AccountRegistry() {
+}
+
+/**
+ *   @brief  Returns the account of a user, shared with the other sessions of the user and
+ *           loaded from the account store if no session holds it. The account is read without
+ *           holding the registry, so logins of other users do not wait for the database.
+ *
+ *   @param  &email is the email of the account
+ *
+ *   @return  shared_ptr<Account> the account, empty if there is no account with the email
+ */
+shared_ptr<Account> AccountRegistry::acquire(const string &email) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = accounts_.find(email);
+        shared_ptr<Account> account = it != accounts_.end() ? it->second.lock() : shared_ptr<Account>();
+        if(account) return account;
+
+        //edits stored from now on are kept for this load
+        loading_[email].loaders++;
+    }
+
+    shared_ptr<Account> loaded = make_shared<Account>("", "", email, "");
+    bool found = AccountStore::instance()->load(email, *loaded);
+
+    lock_guard<mutex> lock(mutex_);
+    Loading &loading = loading_[email];
+    shared_ptr<Account> latest = loading.latest;
+    if(--loading.loaders == 0) loading_.erase(email);
+
+    //another session of the user loaded it meanwhile
+    shared_ptr<Account> account = accounts_[email].lock();
+    if(account) return account;
+
+    if(!found) {
+        accounts_.erase(email);
+        return shared_ptr<Account>();
+    }
+    if(latest) loaded->refresh(*latest);
+    accounts_[email] = loaded;
+
+    //drop the accounts whose sessions have all ended
+    for(auto it = accounts_.begin(); it != accounts_.end();) {
+        if(it->second.expired()) {
+            it = accounts_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+    return loaded;
+}
+
+/**
+ *   @brief  Hand a stored edit of an account to the sessions holding it, called by the account
+ *           store for every edit while the account's lock stripe is held, so edits arrive in order
+ *
+ *   @param  &email is the email of the account
+ *   @param  &stored is the account after the edit
+ *
+ *   @return  void
+ */
+void AccountRegistry::refresh(const string &email, const Account &stored) {
+    shared_ptr<Account> account;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto loading = loading_.find(email);
+        if(loading != loading_.end()) {
+            loading->second.latest = make_shared<Account>(stored);
+        }
+
+        auto it = accounts_.find(email);
+        if(it == accounts_.end()) return;
+        account = it->second.lock();
+    }
+
+    if(account) account->refresh(stored);
+}
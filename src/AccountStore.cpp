@@ -0,0 +1,639 @@
+/**
+ *  @file       AccountStore.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application store of user accounts
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class keeps every account and the bridges registered to it in one SQLite
+ *              database through Wt::Dbo. Accounts are keyed by email, so finding one is an
+ *              indexed lookup, and bridges are rows of their own table that point at their
+ *              account, so sharing a bridge inserts one row instead of rewriting a file.
+ *              Dbo prepares each statement once per connection and reuses it. Accounts kept
+ *              in the old credentials/<email>.txt files are imported the first time the
+ *              database is created.
+ *
+ *              Saving an account is write behind: the account is copied into a pending map
+ *              and the request returns without touching the disk. A flush scheduled on the
+ *              server's io service writes every pending account in one transaction at most
+ *              the flush latency later, so repeated edits of an account are written once.
+ *              Reads see pending accounts first. The database runs in WAL mode with full
+ *              syncs, so a crash leaves each account either as it was or fully written.
+ *              Written accounts are read on a second connection, which WAL lets read while
+ *              a flush commits, so an edit never waits for the disk.
+ *
+ *              The emails of all accounts are kept in memory, loaded when the store opens,
+ *              so lookups of accounts that do not exist never reach the database.
+ *
+ *              Every edit of an account goes through update: the latest copy of the account is
+ *              read, the edit is applied to it and the result is queued, all while holding the
+ *              lock stripe of the account. Two sessions editing the same account, or a session
+ *              sharing a bridge with it, are applied one after the other instead of one copy
+ *              overwriting the other, and edits of other accounts do not wait for them.
+ */
+
+#include <Wt/Dbo/Exception>
+#include <Wt/Dbo/SqlStatement>
+#include <Wt/WServer>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/tuple/tuple.hpp>
+#include <fstream>
+#include "AccountStore.h"
+#include "AccountRegistry.h"
+#include "ProfilePicture.h"
+
+class AccountRecord;
+class BridgeRecord;
+
+namespace Wt {
+namespace Dbo {
+
+// accounts are keyed by their email instead of a generated id
+template<>
+struct dbo_traits<AccountRecord> : public dbo_default_traits {
+    typedef std::string IdType;
+    static IdType invalidId() { return std::string(); }
+    static const char *surrogateIdField() { return 0; }
+};
+
+}
+}
+
+// row of the account table
+class AccountRecord {
+public:
+    string email;
+    string password; // hashed password
+    string firstName;
+    string lastName;
+    string picture; // id of the profile picture, empty for the default picture
+    Dbo::collection<Dbo::ptr<BridgeRecord> > bridges;
+
+    template<class Action>
+    void persist(Action &a) {
+        Dbo::id(a, email, "email", 255);
+        Dbo::field(a, password, "password");
+        Dbo::field(a, firstName, "first_name");
+        Dbo::field(a, lastName, "last_name");
+        Dbo::field(a, picture, "picture");
+        Dbo::hasMany(a, bridges, Dbo::ManyToOne, "account");
+    }
+};
+
+// row of the bridge table, one per bridge registered to an account
+class BridgeRecord {
+public:
+    string name;
+    string location;
+    string ip;
+    string port;
+    string username;
+    Dbo::ptr<AccountRecord> account;
+
+    template<class Action>
+    void persist(Action &a) {
+        Dbo::field(a, name, "name");
+        Dbo::field(a, location, "location");
+        Dbo::field(a, ip, "ip");
+        Dbo::field(a, port, "port");
+        Dbo::field(a, username, "username");
+        Dbo::belongsTo(a, account, "account", Dbo::OnDeleteCascade);
+    }
+};
+
+const char *AccountStore::DATABASE = "ambience.db";
+const char *AccountStore::CREDENTIALS_DIR = "credentials";
+
+/**
+ *   @brief  Shared account store of the server
+ *
+ *   @return  AccountStore* the store
+ */
+AccountStore *AccountStore::instance() {
+    static AccountStore store;
+    return &store;
+}
+
+/**
+ *   @brief  AccountStore constructor, opens the database and creates its tables the first time
+ *
+ */
+AccountStore::AccountStore() :
+connection_(new Dbo::backend::Sqlite3(DATABASE)),
+readConnection_(new Dbo::backend::Sqlite3(DATABASE)),
+flushArmed_(false),
+flushLatency_(FLUSH_LATENCY)
+{
+    try {
+        //a commit reaches the disk before it returns and a torn write is rolled back on open
+        connection_->executeSql("pragma journal_mode = wal");
+        connection_->executeSql("pragma synchronous = full");
+    }
+    catch (Dbo::Exception &e) {
+        cerr << "ACCOUNTS: Unable to configure " << DATABASE << ": " << e.what() << "\n";
+    }
+
+    session_.setConnection(*connection_);
+    session_.mapClass<AccountRecord>("account");
+    session_.mapClass<BridgeRecord>("bridge");
+    readSession_.setConnection(*readConnection_);
+
+    bool exists = true;
+    try {
+        exists = tableExists("account");
+    }
+    catch (Dbo::Exception &e) {
+        cerr << "ACCOUNTS: Unable to read " << DATABASE << ": " << e.what() << "\n";
+    }
+
+    if(!exists) {
+        try {
+            //one transaction, so a failed import leaves no tables and is tried again on the next start
+            Dbo::Transaction transaction(session_);
+            session_.createTables();
+            session_.execute("create index bridge_account on bridge (account_email)");
+            importCredentials();
+            importPictures();
+            transaction.commit();
+            cout << "ACCOUNTS: Created " << DATABASE << "\n";
+        }
+        catch (Dbo::Exception &e) {
+            cerr << "ACCOUNTS: Unable to set up " << DATABASE << ": " << e.what() << "\n";
+        }
+    }
+    else {
+        try {
+            //databases made before profile pictures were thumbnails, the column and the converted
+            //pictures are committed together so a failure is tried again on the next start
+            if(!columnExists("account", "picture")) {
+                Dbo::Transaction transaction(session_);
+                session_.execute("alter table account add column picture text not null default ''");
+                importPictures();
+                transaction.commit();
+            }
+        }
+        catch (Dbo::Exception &e) {
+            cerr << "ACCOUNTS: Unable to add profile pictures to " << DATABASE << ": " << e.what() << "\n";
+        }
+    }
+    loadIndex();
+}
+
+/**
+ *   @brief  Check the database for a table
+ *
+ *   @param  &table is the name of the table
+ *
+ *   @return  bool true if the table exists
+ */
+bool AccountStore::tableExists(const string &table) {
+    Dbo::Transaction transaction(session_);
+    int tables = session_.query<int>("select count(1) from sqlite_master where type = 'table' and name = ?").bind(table);
+    return tables > 0;
+}
+
+/**
+ *   @brief  Check a table of the database for a column
+ *
+ *   @param  &table is the name of the table
+ *   @param  &column is the name of the column
+ *
+ *   @return  bool true if the table has the column
+ */
+bool AccountStore::columnExists(const string &table, const string &column) {
+    //the pragma_table_info() table function needs SQLite 3.16, the pragma statement works on any version
+    unique_ptr<Dbo::SqlStatement> statement(connection_->prepareStatement("pragma table_info(" + table + ")"));
+    statement->execute();
+
+    //one row per column, the name is the second field
+    string name;
+    while (statement->nextRow()) {
+        if (statement->getResult(1, &name, 255) && name == column) return true;
+    }
+    return false;
+}
+
+/**
+ *   @brief  Read the email of every account into the in-memory index
+ *
+ *   @return  void
+ */
+void AccountStore::loadIndex() {
+    try {
+        Dbo::Transaction transaction(session_);
+        Dbo::collection<string> emails = session_.query<string>("select email from account");
+        lock_guard<mutex> indexLock(indexMutex_);
+        emails_.insert(emails.begin(), emails.end());
+        cout << "ACCOUNTS: Indexed " << emails_.size() << " accounts\n";
+    }
+    catch (Dbo::Exception &e) {
+        cerr << "ACCOUNTS: Unable to index " << DATABASE << ": " << e.what() << "\n";
+    }
+}
+
+/**
+ *   @brief  Check the in-memory index for an account
+ *
+ *   @param  &email is the email of the account
+ *
+ *   @return  bool true if there is an account with the email
+ */
+bool AccountStore::indexed(const string &email) {
+    lock_guard<mutex> indexLock(indexMutex_);
+    return emails_.count(email) > 0;
+}
+
+/**
+ *   @brief  Check if an account exists, answered from memory
+ *
+ *   @param  &email is the email of the account
+ *
+ *   @return  bool true if there is an account with the email
+ */
+bool AccountStore::exists(const string &email) {
+    return indexed(email);
+}
+
+/**
+ *   @brief  Read an account and its bridges
+ *
+ *   @param  &email is the email of the account
+ *   @param  &account is filled with the names, hashed password and bridges of the account
+ *
+ *   @return  bool false if there is no account with the email
+ */
+bool AccountStore::load(const string &email, Account &account) {
+    if(!indexed(email)) return false;
+
+    //an account saved but not written yet is newer than its rows
+    if(unwritten(email, account)) return true;
+
+    //read on the second connection, so loading never waits for a flush to reach the disk
+    lock_guard<mutex> lock(readMutex_);
+    try {
+        typedef boost::tuple<string, string, string, string> AccountRow;
+        typedef boost::tuple<string, string, string, string, string> BridgeRow;
+
+        Dbo::Transaction transaction(readSession_);
+        Dbo::collection<AccountRow> rows = readSession_.query<AccountRow>(
+            "select password, first_name, last_name, picture from account where email = ?").bind(email);
+        //a query result is iterated once, the email is the key so there is at most one row
+        Dbo::collection<AccountRow>::const_iterator row = rows.begin();
+        if(row == rows.end()) return false;
+
+        account.setEmail(email);
+        account.setPassword(row->get<0>());
+        account.setFirstName(row->get<1>());
+        account.setLastName(row->get<2>());
+        account.setPicture(row->get<3>());
+
+        //bridges in the order they were added
+        Dbo::collection<BridgeRow> bridges = readSession_.query<BridgeRow>(
+            "select name, location, ip, port, username from bridge where account_email = ? order by id").bind(email);
+        for(Dbo::collection<BridgeRow>::const_iterator it = bridges.begin(); it != bridges.end(); ++it) {
+            account.addBridge(Bridge(it->get<0>(), it->get<1>(), it->get<2>(), it->get<3>(), it->get<4>()));
+        }
+        return true;
+    }
+    catch (Dbo::Exception &e) {
+        cerr << "ACCOUNTS: Unable to load " << email << ": " << e.what() << "\n";
+        return false;
+    }
+}
+
+/**
+ *   @brief  Create an account with no bridges
+ *
+ *   @param  &email is the email of the account
+ *   @param  &password is the hashed password
+ *   @param  &firstName is the first name of the user
+ *   @param  &lastName is the last name of the user
+ *
+ *   @return  bool false if the email is taken or the account could not be stored
+ */
+bool AccountStore::create(const string &email, const string &password, const string &firstName, const string &lastName) {
+    if(exists(email)) return false;
+
+    lock_guard<mutex> lock(mutex_);
+    try {
+        Dbo::Transaction transaction(session_);
+        Dbo::ptr<AccountRecord> existing = session_.find<AccountRecord>().where("email = ?").bind(email);
+        if(existing) return false;
+
+        AccountRecord *record = new AccountRecord();
+        record->email = email;
+        record->password = password;
+        record->firstName = firstName;
+        record->lastName = lastName;
+        session_.add(record);
+        if(!transaction.commit()) return false;
+    }
+    catch (Dbo::Exception &e) {
+        cerr << "ACCOUNTS: Unable to create " << email << ": " << e.what() << "\n";
+        return false;
+    }
+
+    lock_guard<mutex> indexLock(indexMutex_);
+    emails_.insert(email);
+    return true;
+}
+
+/**
+ *   @brief  Edit an account. The edit is applied to the latest copy of the account, including
+ *           edits of other sessions not written yet, and the result is queued to be written and
+ *           handed to the sessions holding the account. Edits of the same account are applied
+ *           one at a time.
+ *
+ *   @param  &email is the email of the account
+ *   @param  &mutation is the edit, called with the latest copy of the account
+ *   @param  &result is set to the account after the edit
+ *
+ *   @return  bool false if there is no account with the email
+ */
+bool AccountStore::update(const string &email, const boost::function<void (Account &)> &mutation, Account &result) {
+    if(!indexed(email)) return false;
+
+    lock_guard<mutex> edit(stripe(email));
+    Account account("", "", email, "");
+    if(!load(email, account)) return false;
+
+    mutation(account);
+    save(account);
+    //sessions holding the account see the edit, including edits made for another user
+    AccountRegistry::instance()->refresh(email, account);
+    result = account;
+    return true;
+}
+
+/**
+ *   @brief  Copy of an account that is queued or being written. Either is newer than its rows.
+ *
+ *   @param  &email is the email of the account
+ *   @param  &account is filled with the names, hashed password and bridges of the account
+ *
+ *   @return  bool false if the rows of the account are current
+ */
+bool AccountStore::unwritten(const string &email, Account &account) {
+    lock_guard<mutex> pendingLock(pendingMutex_);
+    map<string, Account>::iterator it = pending_.find(email);
+    if(it == pending_.end()) {
+        it = flushing_.find(email);
+        if(it == flushing_.end()) return false;
+    }
+
+    //copies share the bridge list
+    account = it->second;
+    return true;
+}
+
+/**
+ *   @brief  Lock stripe of an account
+ *
+ *   @param  &email is the email of the account
+ *
+ *   @return  mutex& the lock held while the account is edited
+ */
+mutex &AccountStore::stripe(const string &email) {
+    return stripes_[hash<string>()(email) % LOCK_STRIPES];
+}
+
+/**
+ *   @brief  Queue the names, hashed password and bridges of an account to be written, creating
+ *           it if needed. Returns without waiting for the disk, the account is written by the
+ *           next flush, at most the flush latency later.
+ *
+ *   @param  &account is the account
+ *
+ *   @return  void
+ */
+void AccountStore::save(Account &account) {
+    {
+        lock_guard<mutex> indexLock(indexMutex_);
+        emails_.insert(account.getEmail());
+    }
+
+    bool armed;
+    int latency;
+    {
+        lock_guard<mutex> pendingLock(pendingMutex_);
+        //a later save replaces the queued copy, so the account is written once
+        pending_.erase(account.getEmail());
+        pending_.insert(make_pair(account.getEmail(), account));
+
+        armed = flushArmed_;
+        flushArmed_ = true;
+        latency = flushLatency_;
+    }
+
+    if(!armed) {
+        if(WServer::instance()) {
+            WServer::instance()->ioService().schedule(latency, boost::bind(&AccountStore::flush, this));
+        }
+        else {
+            //no server to schedule on
+            flush();
+        }
+    }
+}
+
+/**
+ *   @brief  Write every pending account in one transaction. Accounts that could not be written
+ *           stay pending for the next flush unless they were saved again in the meantime.
+ *
+ *   @return  void
+ */
+void AccountStore::flush() {
+    //one flush at a time, the accounts stay readable in flushing_ until their rows are committed
+    lock_guard<mutex> lock(mutex_);
+    map<string, Account> flushing;
+    {
+        lock_guard<mutex> pendingLock(pendingMutex_);
+        flushing_.swap(pending_);
+        flushing = flushing_;
+        flushArmed_ = false;
+    }
+    if(flushing.empty()) return;
+
+    try {
+        Dbo::Transaction transaction(session_);
+        for(map<string, Account>::iterator it = flushing.begin(); it != flushing.end(); ++it) {
+            write(it->second);
+        }
+        transaction.commit();
+
+        lock_guard<mutex> pendingLock(pendingMutex_);
+        flushing_.clear();
+    }
+    catch (Dbo::Exception &e) {
+        cerr << "ACCOUNTS: Unable to write " << flushing.size() << " accounts: " << e.what() << "\n";
+
+        bool armed;
+        int latency;
+        {
+            lock_guard<mutex> pendingLock(pendingMutex_);
+            //insert keeps any newer save of the account
+            pending_.insert(flushing_.begin(), flushing_.end());
+            flushing_.clear();
+            armed = flushArmed_;
+            flushArmed_ = true;
+            latency = flushLatency_;
+        }
+        if(!armed && WServer::instance()) {
+            WServer::instance()->ioService().schedule(latency, boost::bind(&AccountStore::flush, this));
+        }
+    }
+}
+
+/**
+ *   @brief  Set how long a saved account may wait to be written, longer latencies write repeated
+ *           edits fewer times
+ *
+ *   @param  latency is the latency in milliseconds, at least 1
+ */
+void AccountStore::setFlushLatency(int latency) {
+    lock_guard<mutex> pendingLock(pendingMutex_);
+    flushLatency_ = max(latency, 1);
+}
+
+/**
+ *   @brief  How long a saved account may wait to be written
+ *
+ *   @return  int the latency in milliseconds
+ */
+int AccountStore::getFlushLatency() {
+    lock_guard<mutex> pendingLock(pendingMutex_);
+    return flushLatency_;
+}
+
+/**
+ *   @brief  Write the names, hashed password and bridges of an account in the open transaction,
+ *           creating it if needed
+ *
+ *   @param  &account is the account
+ */
+void AccountStore::write(Account &account) {
+    Dbo::ptr<AccountRecord> record = session_.find<AccountRecord>().where("email = ?").bind(account.getEmail());
+    if(!record) {
+        AccountRecord *added = new AccountRecord();
+        added->email = account.getEmail();
+        record = session_.add(added);
+    }
+
+    AccountRecord *modified = record.modify();
+    modified->password = account.getPassword();
+    modified->firstName = account.getFirstName();
+    modified->lastName = account.getLastName();
+    modified->picture = account.getPicture();
+
+    //an account has a handful of bridges, its rows are replaced
+    vector<Dbo::ptr<BridgeRecord> > old(modified->bridges.begin(), modified->bridges.end());
+    for(Dbo::ptr<BridgeRecord> &bridge : old) {
+        bridge.remove();
+    }
+    for(const Bridge &bridge : *account.getBridges()) {
+        BridgeRecord *row = new BridgeRecord();
+        row->name = bridge.getName();
+        row->location = bridge.getLocation();
+        row->ip = bridge.getIP();
+        row->port = bridge.getPort();
+        row->username = bridge.getUsername();
+        row->account = record;
+        session_.add(row);
+    }
+}
+
+/**
+ *   @brief  Add a bridge to an account, used to share a bridge with another user
+ *
+ *   @param  &email is the email of the account
+ *   @param  &bridge is the bridge to add
+ *
+ *   @return  bool false if there is no account with the email
+ */
+bool AccountStore::addBridge(const string &email, const Bridge &bridge) {
+    Account result("", "", email, "");
+    return update(email, boost::bind(static_cast<void (Account::*)(Bridge)>(&Account::addBridge), _1, bridge), result);
+}
+
+/**
+ *   @brief  Import the accounts of the old credentials/<email>.txt files into a new database.
+ *           Each file is the hashed password, first name and last name on their own lines
+ *           followed by one "name, location, ip, port, username" line per bridge. Run inside
+ *           the transaction that creates the tables.
+ *
+ *   @return  void
+ */
+void AccountStore::importCredentials() {
+    boost::system::error_code err;
+    if(!boost::filesystem::is_directory(CREDENTIALS_DIR, err)) return;
+
+    int imported = 0;
+    Dbo::Transaction transaction(session_);
+    for(boost::filesystem::directory_iterator it(CREDENTIALS_DIR, err), end; it != end; it.increment(err)) {
+        if(it->path().extension() != ".txt") continue;
+
+        ifstream inFile(it->path().string().c_str());
+        AccountRecord *record = new AccountRecord();
+        record->email = it->path().stem().string();
+        getline(inFile, record->password);
+        getline(inFile, record->firstName);
+        getline(inFile, record->lastName);
+        Dbo::ptr<AccountRecord> account = session_.add(record);
+
+        string line;
+        while(getline(inFile, line)) {
+            vector<string> fields;
+            size_t begin = 0, end;
+            while((end = line.find(", ", begin)) != string::npos && fields.size() < 4) {
+                fields.push_back(line.substr(begin, end - begin));
+                begin = end + 2;
+            }
+            fields.push_back(line.substr(begin));
+            if(fields.size() != 5) continue;
+
+            BridgeRecord *row = new BridgeRecord();
+            row->name = fields[0];
+            row->location = fields[1];
+            row->ip = fields[2];
+            row->port = fields[3];
+            row->username = fields[4];
+            row->account = account;
+            session_.add(row);
+        }
+        imported++;
+    }
+    transaction.commit();
+    cout << "ACCOUNTS: Imported " << imported << " accounts from " << CREDENTIALS_DIR << "\n";
+}
+
+/**
+ *   @brief  Make thumbnails of the pictures accounts uploaded before pictures were thumbnails,
+ *           which were kept full size as Wt/images/ppics/<email>. Run inside the transaction
+ *           that adds the picture column.
+ *
+ *   @return  void
+ */
+void AccountStore::importPictures() {
+    const string directory = "Wt/images/ppics/";
+
+    int imported = 0;
+    Dbo::Transaction transaction(session_);
+    Dbo::collection<Dbo::ptr<AccountRecord> > found = session_.find<AccountRecord>();
+    vector<Dbo::ptr<AccountRecord> > accounts(found.begin(), found.end());
+    for(Dbo::ptr<AccountRecord> &account : accounts) {
+        boost::system::error_code err;
+        string file = directory + account->email;
+        if(!boost::filesystem::is_regular_file(file, err)) continue;
+
+        string picture = ProfilePicture::store(file);
+        if(picture == "") continue;
+        account.modify()->picture = picture;
+        imported++;
+    }
+    transaction.commit();
+    cout << "ACCOUNTS: Imported " << imported << " profile pictures\n";
+}
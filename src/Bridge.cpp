@@ -30,12 +30,12 @@
 Bridge::Bridge(string name, string location,
                string ip, string port, string username)
 {
-    bridgename_ = name;
-    ip_ = ip;
-    location_ = location;
-    port_ = port;
-    username_ = username;
-    //lights.reserve(15); //todo: implement
+    bridgename_ = move(name);
+    ip_ = move(ip);
+    location_ = move(location);
+    port_ = move(port);
+    username_ = move(username);
+    state_ = make_shared<BridgeState>();
 }
 
 /**
@@ -45,3 +45,15 @@ Bridge::Bridge(string name, string location,
 Bridge::~Bridge() {
     
 }
+
+/**
+ *   @brief  Replace the stored state of the Bridge with a snapshot, which may be shared with
+ *           other sessions viewing the same bridge and must not be changed
+ *
+ *   @param  state is the snapshot of the bridge
+ *
+ *   @return  void
+ */
+void Bridge::setState(shared_ptr<BridgeState> state) {
+    state_ = state;
+}
@@ -0,0 +1,474 @@
+/**
+ *  @file       BridgeClient.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application HTTP client service for a single Bridge
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class sends the Hue API requests of a session to one Bridge. A small fixed
+ *              set of Http::Client objects is created once and reused for every request, at most
+ *              MAX_CONNECTIONS requests are in flight and the rest wait in order. Requests are
+ *              tagged with the object that made them so that object can cancel its callbacks
+ *              before it is deleted.
+ */
+
+#include "BridgeClient.h"
+#include <iostream>
+#include <boost/bind.hpp>
+#include <Wt/Json/Serializer>
+#include <Wt/WApplication>
+
+/**
+ *   @brief  BridgeClient constructor
+ *
+ *   @param  ip is the ip of the bridge URL
+ *   @param  port is the port of the bridge URL
+ *   @param  *parent is the object that owns this client, normally the session's main screen
+ *
+ */
+BridgeClient::BridgeClient(string ip, string port, WObject *parent):
+WObject(parent),
+nextId_(0)
+{
+    ip_ = ip;
+    port_ = port;
+}
+
+/**
+ *   @brief  BridgeClient destructor, the Http::Client objects are children and are deleted with it.
+ *           Requests still waiting on the rate limit are dropped so granted() never runs on a
+ *           deleted client.
+ *
+ */
+BridgeClient::~BridgeClient() {
+    BridgeScheduler::instance()->cancel(this);
+}
+
+/**
+ *   @brief  Queue a GET request
+ *
+ *   @param  url is the url of the resource to GET
+ *   @param  *owner is the object the callback belongs to
+ *   @param  done is called with the result of the request
+ *   @param  priority is the priority of the request, refreshes run in the background by default
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::get(const string &url, WObject *owner, const Callback &done, BridgeScheduler::Priority priority) {
+    enqueue("GET", url, "", owner, done, priority);
+}
+
+/**
+ *   @brief  Queue a GET request whose body is handed over in chunks as it arrives instead of being
+ *           collected in the response, for bodies too large to keep in memory
+ *
+ *   @param  url is the url of the resource to GET
+ *   @param  *owner is the object the callbacks belong to
+ *   @param  data is called with each chunk of the body
+ *   @param  done is called with the result of the request, the response has no body
+ *   @param  priority is the priority of the request, refreshes run in the background by default
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::getStreaming(const string &url, WObject *owner, const DataCallback &data, const Callback &done,
+                                BridgeScheduler::Priority priority) {
+    enqueue("GET", url, "", owner, done, priority, data);
+}
+
+/**
+ *   @brief  Queue a PUT request
+ *
+ *   @param  url is the url of the resource to PUT the json data to
+ *   @param  body is the json data to send
+ *   @param  *owner is the object the callback belongs to
+ *   @param  done is called with the result of the request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::put(const string &url, const string &body, WObject *owner, const Callback &done) {
+    enqueue("PUT", url, body, owner, done, url.find("/schedules") != string::npos ? BridgeScheduler::Bulk : BridgeScheduler::Interactive);
+}
+
+/**
+ *   @brief  Queue a POST request
+ *
+ *   @param  url is the url of the resource to POST the json data to
+ *   @param  body is the json data to send
+ *   @param  *owner is the object the callback belongs to
+ *   @param  done is called with the result of the request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::post(const string &url, const string &body, WObject *owner, const Callback &done) {
+    enqueue("POST", url, body, owner, done, url.find("/schedules") != string::npos ? BridgeScheduler::Bulk : BridgeScheduler::Interactive);
+}
+
+/**
+ *   @brief  Queue a DELETE request
+ *
+ *   @param  url is the url of the resource to DELETE
+ *   @param  *owner is the object the callback belongs to
+ *   @param  done is called with the result of the request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::deleteRequest(const string &url, WObject *owner, const Callback &done) {
+    enqueue("DELETE", url, "", owner, done, url.find("/schedules") != string::npos ? BridgeScheduler::Bulk : BridgeScheduler::Interactive);
+}
+
+/**
+ *   @brief  Queue a PUT command that may be merged with later commands to the same url. While a
+ *           command to the url is in flight, newer commands only replace the pending value of
+ *           each attribute, so a dragged slider sends its latest value once the previous
+ *           command completes instead of every value in between. Every merged command is called
+ *           back with the response of the request that carried it.
+ *
+ *   @param  url is the url of the resource to PUT the json data to, e.g. /lights/1/state
+ *   @param  body is the attributes to set
+ *   @param  *owner is the object the callback belongs to
+ *   @param  done is called with the result of the request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::putLatest(const string &url, const Json::Object &body, WObject *owner, const Callback &done) {
+    static const char *colours[] = {"xy", "hue", "sat", "ct"};
+
+    Coalesced &entry = latest_[url];
+
+    //a newer colour replaces a pending colour given in another colour mode
+    bool colour = false;
+    for(const char *key : colours) {
+        if(body.count(key)) colour = true;
+    }
+    if(colour) {
+        for(const char *key : colours) {
+            if(!body.count(key)) entry.body.erase(key);
+        }
+    }
+
+    for(auto &attribute : body) {
+        entry.body[attribute.first] = attribute.second;
+    }
+    entry.waiting.push_back(make_pair(owner, done));
+
+    if(!entry.inFlight) {
+        sendLatest(url);
+    }
+}
+
+/**
+ *   @brief  Send the pending attributes of a coalesced url as one PUT request
+ *
+ *   @param  url is the url of the resource
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::sendLatest(const string &url) {
+    Coalesced &entry = latest_[url];
+    string body = Json::serialize(entry.body);
+
+    entry.inFlight = true;
+    entry.body.clear();
+    entry.sent = entry.waiting;
+    entry.waiting.clear();
+
+    enqueue("PUT", url, body, this, boost::bind(&BridgeClient::handleLatest, this, url, _1, _2), BridgeScheduler::Interactive);
+}
+
+/**
+ *   @brief  Function to handle the response of a coalesced PUT request, sends the attributes
+ *           that were merged meanwhile and calls back every command the request carried
+ *
+ *   @param  url is the url of the resource
+ *   @param  *err stores the error code generated by an Http request, null if request was successful
+ *   @param  &response stores the response message generated by the Http request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::handleLatest(const string &url, boost::system::error_code err, const Http::Message &response) {
+    Coalesced &entry = latest_[url];
+    vector<pair<WObject *, Callback> > sent = entry.sent;
+    entry.sent.clear();
+    entry.inFlight = false;
+
+    if(!entry.waiting.empty()) {
+        sendLatest(url);
+    }
+    else {
+        latest_.erase(url);
+    }
+
+    for(auto &command : sent) {
+        if(command.second) command.second(err, response);
+    }
+}
+
+/**
+ *   @brief  Cancel the callbacks of an object, queued requests are dropped and requests in
+ *           flight complete without calling back. Must be called before the owner is deleted.
+ *
+ *   @param  *owner is the object whose requests are cancelled
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::cancel(WObject *owner) {
+    for(auto it = scheduled_.begin(); it != scheduled_.end();) {
+        if(it->second.owner == owner) {
+            scheduled_.erase(it++);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for(auto it = queue_.begin(); it != queue_.end();) {
+        if(it->owner == owner) {
+            it = queue_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    for(auto &entry : active_) {
+        if(entry.second.owner == owner) {
+            entry.second.owner = 0;
+            entry.second.data = 0;
+            entry.second.done = 0;
+        }
+    }
+
+    //coalesced commands are still sent, only the callbacks are dropped
+    for(auto &entry : latest_) {
+        for(auto &command : entry.second.waiting) {
+            if(command.first == owner) command.second = 0;
+        }
+        for(auto &command : entry.second.sent) {
+            if(command.first == owner) command.second = 0;
+        }
+    }
+}
+
+/**
+ *   @brief  Hand a request to the process-wide scheduler, which calls granted() in this session
+ *           once the rate budget of the bridge allows it to be sent
+ *
+ *   @param  method is the HTTP method of the request
+ *   @param  url is the url of the resource
+ *   @param  body is the json data to send, empty for GET and DELETE
+ *   @param  *owner is the object the callback belongs to
+ *   @param  done is called with the result of the request
+ *   @param  priority is the priority of the request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::enqueue(const string &method, const string &url, const string &body, WObject *owner, const Callback &done,
+                           BridgeScheduler::Priority priority, const DataCallback &data) {
+    Request request;
+    request.method = method;
+    request.url = url;
+    request.body = body;
+    request.owner = owner;
+    request.data = data;
+    request.done = done;
+
+    cout << method << ": " << url << "\n";
+    int id = nextId_++;
+    scheduled_[id] = request;
+    BridgeScheduler::instance()->schedule(bridgeKey(ip_, port_, url), budget(url), priority,
+                                          WApplication::instance()->sessionId(),
+                                          boost::bind(&BridgeClient::granted, this, id), this);
+}
+
+/**
+ *   @brief  Called in this session by the scheduler when a request may be sent, moves it to the
+ *           connection queue unless it was cancelled meanwhile
+ *
+ *   @param  id is the id of the request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::granted(int id) {
+    auto it = scheduled_.find(id);
+    if(it == scheduled_.end()) return;
+
+    queue_.push_back(it->second);
+    scheduled_.erase(it);
+    dispatch();
+}
+
+/**
+ *   @brief  Build the scheduler key of a request, ip:port:username
+ *
+ *   @param  ip is the ip of the bridge URL
+ *   @param  port is the port of the bridge URL
+ *   @param  url is the url of the request, http://ip:port/api/<username>/...
+ *
+ *   @return  string the bridge key
+ *
+ */
+string BridgeClient::bridgeKey(const string &ip, const string &port, const string &url) {
+    string username = "";
+    size_t api = url.find("/api/");
+    if(api != string::npos) {
+        size_t start = api + 5;
+        username = url.substr(start, url.find('/', start) - start);
+    }
+    return ip + ":" + port + ":" + username;
+}
+
+/**
+ *   @brief  Returns the rate budget of a request, group actions are limited separately since
+ *           the bridge sends them to every light of the group
+ *
+ *   @param  url is the url of the request
+ *
+ *   @return  BridgeScheduler::Budget the budget to charge
+ *
+ */
+BridgeScheduler::Budget BridgeClient::budget(const string &url) {
+    if(url.find("/groups/") != string::npos && url.find("/action") != string::npos) {
+        return BridgeScheduler::Groups;
+    }
+    return BridgeScheduler::Commands;
+}
+
+/**
+ *   @brief  Send queued requests while there are free connections, creating clients up to
+ *           MAX_CONNECTIONS the first time they are needed
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::dispatch() {
+    while(!queue_.empty() && (int)active_.size() < MAX_CONNECTIONS) {
+        Http::Client *client;
+        if(!idle_.empty()) {
+            client = idle_.back();
+            idle_.pop_back();
+        }
+        else {
+            client = new Http::Client(this);
+            client->setTimeout(TIMEOUT);
+            client->done().connect(boost::bind(&BridgeClient::handleDone, this, client, _1, _2));
+        }
+
+        Request request = queue_.front();
+        queue_.pop_front();
+
+        //a connected bodyDataReceived() stops the client from collecting the body, so it is only
+        //connected for the streamed request
+        if(request.data) {
+            client->setMaximumResponseSize(MAX_STREAM_SIZE);
+            streams_[client] = client->bodyDataReceived().connect(boost::bind(&BridgeClient::handleData, this, client, _1));
+        }
+        else {
+            client->setMaximumResponseSize(MAX_RESPONSE_SIZE);
+        }
+
+        if(send(client, request)) {
+            active_[client] = request;
+        }
+        else {
+            cerr << request.method << ": Error sending request to " << request.url << "\n";
+            if(request.data) {
+                streams_[client].disconnect();
+                streams_.erase(client);
+            }
+            idle_.push_back(client);
+            if(request.done) {
+                request.done(boost::system::errc::make_error_code(boost::system::errc::invalid_argument), Http::Message());
+            }
+        }
+    }
+}
+
+/**
+ *   @brief  Start a request on a client
+ *
+ *   @param  *client is the free client to use
+ *   @param  request is the request to send
+ *
+ *   @return  bool true if the request was started
+ *
+ */
+bool BridgeClient::send(Http::Client *client, const Request &request) {
+    if(request.method == "GET") {
+        return client->get(request.url);
+    }
+
+    Http::Message message;
+    message.addBodyText(request.body);
+
+    if(request.method == "PUT") {
+        return client->put(request.url, message);
+    }
+    else if(request.method == "POST") {
+        return client->post(request.url, message);
+    }
+    else {
+        return client->deleteRequest(request.url, message);
+    }
+}
+
+/**
+ *   @brief  Function to handle the bodyDataReceived() signal of a client sending a streamed request,
+ *           hands the chunk to the owner unless it was cancelled
+ *
+ *   @param  *client is the client that received the chunk
+ *   @param  &data is the chunk of the body
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::handleData(Http::Client *client, const string &data) {
+    auto it = active_.find(client);
+    if(it != active_.end() && it->second.data) {
+        it->second.data(data);
+    }
+}
+
+/**
+ *   @brief  Function to handle the done() signal of a client, frees the client for the next
+ *           request and calls back the owner of the finished one unless it was cancelled
+ *
+ *   @param  *client is the client that finished
+ *   @param  *err stores the error code generated by an Http request, null if request was successful
+ *   @param  &response stores the response message generated by the Http request
+ *
+ *   @return  void
+ *
+ */
+void BridgeClient::handleDone(Http::Client *client, boost::system::error_code err, const Http::Message &response) {
+    auto stream = streams_.find(client);
+    if(stream != streams_.end()) {
+        stream->second.disconnect();
+        streams_.erase(stream);
+    }
+
+    auto it = active_.find(client);
+    if(it == active_.end()) return;
+
+    Callback done = it->second.done;
+    active_.erase(it);
+    idle_.push_back(client);
+
+    if(done) {
+        done(err, response);
+    }
+    dispatch();
+}
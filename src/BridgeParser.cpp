@@ -0,0 +1,229 @@
+/**
+ *  @file       BridgeParser.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application streaming parser of a Bridge's /api/<username> body
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class reads the JSON body of a Bridge in chunks as they arrive and fills a
+ *              BridgeState directly. Only the structure of the body is tracked, so subtrees the
+ *              application does not use (rules, sensors, resourcelinks, scenes) are skipped
+ *              without being stored. Each light, group and schedule, and the config, is copied
+ *              on its own and handed to the Light, Group and Schedule constructors, so memory
+ *              use is bounded by the largest single entry rather than the size of the body.
+ *              The body of a single resource such as /lights is read the same way.
+ */
+
+#include "BridgeParser.h"
+
+/**
+ *   @brief  BridgeParser constructor
+ *
+ *   @param  resource is the resource the body holds, AllResources for the whole /api/<username> body
+ *
+ */
+BridgeParser::BridgeParser(BridgeState::Resource resource) :
+state_(make_shared<BridgeState>()),
+resource_(resource),
+base_(resource == BridgeState::AllResources ? 1 : 0),
+section_(resource),
+entryDepth_(0),
+inString_(false),
+escape_(false),
+expectKey_(false),
+keepKey_(false),
+capturing_(false),
+oversized_(false),
+done_(false),
+failed_(false),
+fingerprint_(14695981039346656037ULL),
+size_(0)
+{
+
+}
+
+/**
+ *   @brief  BridgeParser destructor
+ *
+ */
+BridgeParser::~BridgeParser() {
+
+}
+
+/**
+ *   @brief  Read the next chunk of the body
+ *
+ *   @param  &data is the chunk
+ *
+ *   @return  void
+ */
+void BridgeParser::feed(const string &data) {
+    for(char c : data) {
+        read(c);
+    }
+    size_ += data.size();
+}
+
+/**
+ *   @brief  Finish reading the body
+ *
+ *   @return  shared_ptr<BridgeState> the filled state, null if the body was not a complete bridge object
+ */
+shared_ptr<BridgeState> BridgeParser::finish() {
+    if(failed_ || !done_) {
+        cerr << "BRIDGE: Unable to parse bridge JSON after " << size_ << " bytes\n";
+        return shared_ptr<BridgeState>();
+    }
+
+    chrono::steady_clock::time_point now = chrono::steady_clock::now();
+    for(int i = 0; i < BridgeState::AllResources; i++) {
+        if(resource_ == BridgeState::AllResources || resource_ == i) {
+            state_->loaded_[i] = true;
+            state_->fetched_[i] = now;
+        }
+    }
+    return state_;
+}
+
+/**
+ *   @brief  Read one character of the body
+ *
+ *   @param  c is the character
+ *
+ *   @return  void
+ */
+void BridgeParser::read(char c) {
+    fingerprint_ = (fingerprint_ ^ (unsigned char)c) * 1099511628211ULL;
+    if(failed_) return;
+
+    if(!inString_ && c == '{' && !capturing_ &&
+       ((containers_.size() == base_ + 1 && section_ < BridgeState::Config) ||
+        (containers_.size() == base_ && section_ == BridgeState::Config))) {
+        capturing_ = true;
+        oversized_ = false;
+        entryDepth_ = containers_.size();
+        entry_.clear();
+    }
+
+    if(capturing_ && !oversized_) {
+        entry_ += c;
+        if(entry_.size() > MAX_ENTRY_SIZE) {
+            oversized_ = true;
+            string().swap(entry_);
+        }
+    }
+
+    if(inString_) {
+        if(escape_) {
+            escape_ = false;
+            if(keepKey_) key_ += c;
+        }
+        else if(c == '\\') {
+            escape_ = true;
+        }
+        else if(c == '"') {
+            inString_ = false;
+            if(keepKey_) endKey();
+        }
+        else if(keepKey_) {
+            key_ += c;
+        }
+        return;
+    }
+
+    switch(c) {
+        case '"':
+            inString_ = true;
+            keepKey_ = expectKey_ && containers_.size() <= base_ + 1;
+            if(keepKey_) key_.clear();
+            break;
+        case '{':
+        case '[':
+            //the body must be one object, the Hue API answers errors with an array
+            if(done_ || (containers_.empty() && c != '{')) {
+                failed_ = true;
+                return;
+            }
+            containers_ += c;
+            expectKey_ = c == '{';
+            break;
+        case '}':
+        case ']':
+            if(containers_.empty() || containers_[containers_.size() - 1] != (c == '}' ? '{' : '[')) {
+                failed_ = true;
+                return;
+            }
+            containers_.erase(containers_.size() - 1);
+            if(capturing_ && containers_.size() == entryDepth_) endEntry();
+            if(base_ == 1 && containers_.size() == 1) section_ = BridgeState::AllResources;
+            if(containers_.empty()) done_ = true;
+            expectKey_ = false;
+            break;
+        case ':':
+            expectKey_ = false;
+            break;
+        case ',':
+            expectKey_ = !containers_.empty() && containers_[containers_.size() - 1] == '{';
+            break;
+        default:
+            //numbers, true, false, null and white space only matter inside a copied entry
+            break;
+    }
+}
+
+/**
+ *   @brief  Handle a key read above the entries. In the whole bridge body a top level key picks
+ *           the resource, otherwise the key is the number of the next light, group or schedule.
+ *
+ *   @return  void
+ */
+void BridgeParser::endKey() {
+    if(base_ != 1 || containers_.size() != 1) return;
+
+    if(key_ == "lights") section_ = BridgeState::Lights;
+    else if(key_ == "groups") section_ = BridgeState::Groups;
+    else if(key_ == "schedules") section_ = BridgeState::Schedules;
+    else if(key_ == "config") section_ = BridgeState::Config;
+    else section_ = BridgeState::AllResources;
+}
+
+/**
+ *   @brief  Build the light, group, schedule or config from the entry that was just closed
+ *
+ *   @return  void
+ */
+void BridgeParser::endEntry() {
+    capturing_ = false;
+    if(oversized_) {
+        cerr << "BRIDGE: Skipping entry " << key_ << " larger than " << MAX_ENTRY_SIZE << " bytes\n";
+        return;
+    }
+
+    Json::Object data;
+    try {
+        Json::parse(entry_, data);
+    }
+    catch (Json::ParseError &e) {
+        cerr << "BRIDGE: Unable to parse entry " << key_ << ": " << e.what() << "\n";
+        return;
+    }
+
+    if(section_ == BridgeState::Config) {
+        if(data.type("name") == Json::StringType) state_->name_ = data.get("name").orIfNull("").toUTF8();
+        if(data.type("modelid") == Json::StringType) state_->modelid_ = data.get("modelid").orIfNull("").toUTF8();
+        if(data.type("swversion") == Json::StringType) state_->swversion_ = data.get("swversion").orIfNull("").toUTF8();
+        if(data.type("apiversion") == Json::StringType) state_->apiversion_ = data.get("apiversion").orIfNull("").toUTF8();
+        if(data.type("mac") == Json::StringType) state_->mac_ = data.get("mac").orIfNull("").toUTF8();
+        return;
+    }
+
+    int num = BridgeState::parseKey(key_);
+    if(num < 0) return;
+
+    if(section_ == BridgeState::Lights) state_->lights_.insert(make_pair(num, Light(key_, data)));
+    else if(section_ == BridgeState::Groups) state_->groups_.insert(make_pair(num, Group(key_, data)));
+    else if(section_ == BridgeState::Schedules) state_->schedules_.insert(make_pair(num, Schedule(key_, data)));
+}
@@ -0,0 +1,498 @@
+/**
+ *  @file       BridgeRegistry.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application server-wide cache of Bridge state
+ *
+ *  @section    DESCRIPTION
+ *
+ *              Sessions viewing the same bridge (ip:port:username) share one BridgeState
+ *              snapshot held here. While any session watches a bridge, one poll loop outside of
+ *              the sessions fetches it and every changed snapshot is handed to the watching
+ *              sessions with WServer::post. Only the resources a session has loaded (lights,
+ *              groups, schedules) are polled, each from its own endpoint. The loop polls quickly while someone sends commands to
+ *              the bridge and slowly once it is idle. Snapshots are never changed once published,
+ *              changes made by a session are applied to a copy which then replaces the snapshot.
+ */
+
+#include "BridgeRegistry.h"
+#include "BridgeScheduler.h"
+#include "BridgeClient.h"
+#include <Wt/WServer>
+#include <Wt/WIOService>
+#include <boost/bind.hpp>
+#include <vector>
+
+/**
+ *   @brief  Returns the registry shared by every session of the process
+ *
+ *   @return  BridgeRegistry* the registry
+ */
+BridgeRegistry *BridgeRegistry::instance() {
+    static BridgeRegistry registry;
+    return &registry;
+}
+
+/**
+ *   @brief  BridgeRegistry constructor
+ *
+ */
+BridgeRegistry::BridgeRegistry():
+nextId_(0)
+{
+
+}
+
+/**
+ *   @brief  Build the registry key of a bridge
+ *
+ *   @param  ip is the ip of the bridge URL
+ *   @param  port is the port of the bridge URL
+ *   @param  username is the username of the bridge URL
+ *
+ *   @return  string the key, ip:port:username
+ */
+string BridgeRegistry::bridgeKey(const string &ip, const string &port, const string &username) {
+    return ip + ":" + port + ":" + username;
+}
+
+/**
+ *   @brief  Start watching a bridge from a session. The first subscriber starts the poll loop
+ *           of the bridge, from the snapshot the session already loaded if nobody else has one.
+ *
+ *   @param  ip is the ip of the bridge URL
+ *   @param  port is the port of the bridge URL
+ *   @param  username is the username of the bridge URL
+ *   @param  sessionId is the session the listener is run in
+ *   @param  listener is called with every new snapshot of the bridge
+ *   @param  seed is the snapshot of the bridge loaded by the session, may be empty
+ *
+ *   @return  int the subscription id to pass to unsubscribe()
+ */
+int BridgeRegistry::subscribe(const string &ip, const string &port, const string &username,
+                              const string &sessionId, const Listener &listener, shared_ptr<BridgeState> seed) {
+    string bridge = bridgeKey(ip, port, username);
+    int id;
+    bool first;
+    {
+        lock_guard<mutex> lock(mutex_);
+        Entry &entry = getEntry(ip, port, username);
+        entry.lastActivity = Clock::now();
+        if(!entry.state) entry.state = seed;
+        id = nextId_++;
+        entry.subscribers[id].sessionId = sessionId;
+        entry.subscribers[id].listener = listener;
+        subscriptions_[id] = bridge;
+        first = entry.subscribers.size() == 1;
+    }
+
+    if(first) poll(bridge);
+    return id;
+}
+
+/**
+ *   @brief  Stop watching a bridge. Must be called from the subscribing session before the
+ *           listener's object is deleted, snapshots already posted to the session are dropped.
+ *           The last subscriber to leave releases the bridge.
+ *
+ *   @param  id is the subscription id returned by subscribe()
+ *
+ *   @return  void
+ */
+void BridgeRegistry::unsubscribe(int id) {
+    string bridge;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = subscriptions_.find(id);
+        if(it == subscriptions_.end()) return;
+
+        bridge = it->second;
+        entries_[bridge].subscribers.erase(id);
+        subscriptions_.erase(it);
+    }
+    release(bridge);
+}
+
+/**
+ *   @brief  Forget a bridge nobody watches once its poll has ended. Its client is deleted on
+ *           the io service, after the handler that may still be running on it has returned.
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::release(const string &bridge) {
+    Http::Client *client;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = entries_.find(bridge);
+        if(it == entries_.end() || !it->second.subscribers.empty() || it->second.polling) return;
+
+        client = it->second.client;
+        entries_.erase(it);
+    }
+    if(client) WServer::instance()->ioService().post(boost::bind(&BridgeRegistry::deleteClient, client));
+}
+
+/**
+ *   @brief  Delete the poll client of a released bridge
+ *
+ *   @param  *client is the client to delete
+ *
+ *   @return  void
+ */
+void BridgeRegistry::deleteClient(Http::Client *client) {
+    delete client;
+}
+
+/**
+ *   @brief  Poll a bridge now instead of waiting for the next poll
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::refresh(const string &bridge) {
+    poll(bridge);
+}
+
+/**
+ *   @brief  Mark a bridge as in use, so it is polled at the fast interval. A bridge that was idle
+ *           is polled right away.
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::touch(const string &bridge) {
+    bool wasIdle;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = entries_.find(bridge);
+        if(it == entries_.end()) return;
+
+        Clock::time_point now = Clock::now();
+        wasIdle = now - it->second.lastActivity > chrono::milliseconds(ACTIVE_PERIOD);
+        it->second.lastActivity = now;
+    }
+
+    if(wasIdle) poll(bridge);
+}
+
+/**
+ *   @brief  Returns the snapshot of a bridge that is being watched, so a session can use it
+ *           without fetching the bridge itself
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  shared_ptr<BridgeState> the snapshot, empty if the bridge is not polled
+ */
+shared_ptr<BridgeState> BridgeRegistry::getPolled(const string &bridge) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = entries_.find(bridge);
+    if(it == entries_.end() || it->second.subscribers.empty()) return shared_ptr<BridgeState>();
+    return it->second.state;
+}
+
+/**
+ *   @brief  Merge a body fetched by a session, the whole bridge or one resource of it, into the
+ *           snapshot of the bridge and hand the new snapshot to the watching sessions. The
+ *           snapshot of a bridge nobody watches is not kept, only returned to the session.
+ *
+ *   @param  ip is the ip of the bridge URL
+ *   @param  port is the port of the bridge URL
+ *   @param  username is the username of the bridge URL
+ *   @param  &parser has read the whole body returned by the Hue API
+ *
+ *   @return  shared_ptr<BridgeState> the new snapshot, empty if the body could not be parsed
+ */
+shared_ptr<BridgeState> BridgeRegistry::setState(const string &ip, const string &port, const string &username, BridgeParser &parser) {
+    shared_ptr<BridgeState> parsed = parser.finish();
+    if(!parsed) return parsed;
+
+    lock_guard<mutex> lock(mutex_);
+    auto it = entries_.find(bridgeKey(ip, port, username));
+    if(it == entries_.end() || it->second.subscribers.empty()) {
+        shared_ptr<BridgeState> state = make_shared<BridgeState>();
+        state->merge(*parsed);
+        return state;
+    }
+
+    Entry &entry = it->second;
+    shared_ptr<BridgeState> state = entry.state ? make_shared<BridgeState>(*entry.state) : make_shared<BridgeState>();
+    state->merge(*parsed);
+    entry.state = state;
+    entry.version++;
+    entry.fingerprints[parser.getResource()] = parser.getFingerprint();
+    publish(entry, -1);
+    return state;
+}
+
+/**
+ *   @brief  Apply the success results of a command to a copy of the snapshot of a bridge, which
+ *           replaces the snapshot and is handed to the other watching sessions
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *   @param  id is the subscription of the session that sent the command, it is not called back
+ *   @param  resource is the path of the request below /api/<username>
+ *   @param  request is the JSON body that was sent with the request
+ *   @param  response is the JSON body returned by the Hue API
+ *
+ *   @return  shared_ptr<BridgeState> the new snapshot, empty if the response could not be applied
+ */
+shared_ptr<BridgeState> BridgeRegistry::applyResponse(const string &bridge, int id, const string &resource,
+                                                      const string &request, const string &response) {
+    lock_guard<mutex> lock(mutex_);
+    auto it = entries_.find(bridge);
+    if(it == entries_.end() || !it->second.state) return shared_ptr<BridgeState>();
+
+    shared_ptr<BridgeState> state = make_shared<BridgeState>(*it->second.state);
+    if(!state->applyResponse(resource, request, response)) return shared_ptr<BridgeState>();
+
+    it->second.state = state;
+    it->second.version++;
+    publish(it->second, id);
+    return state;
+}
+
+/**
+ *   @brief  Returns the entry of a bridge, creating it on first use. mutex_ must be held.
+ *
+ *   @param  ip is the ip of the bridge URL
+ *   @param  port is the port of the bridge URL
+ *   @param  username is the username of the bridge URL
+ *
+ *   @return  Entry& the entry of the bridge
+ */
+BridgeRegistry::Entry &BridgeRegistry::getEntry(const string &ip, const string &port, const string &username) {
+    Entry &entry = entries_[bridgeKey(ip, port, username)];
+    if(entry.url == "") {
+        entry.url = "http://" + ip + ":" + port + "/api/" + username;
+    }
+    return entry;
+}
+
+/**
+ *   @brief  Start a poll of a bridge unless one is already running or nobody watches it. A
+ *           poll fetches each loaded resource in turn, every request waits its turn in the
+ *           bridge's rate-limited queue as a background request.
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::poll(const string &bridge) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = entries_.find(bridge);
+        if(it == entries_.end() || it->second.subscribers.empty() || it->second.polling) return;
+
+        Entry &entry = it->second;
+        entry.pollQueue.clear();
+        for(int i = BridgeState::Lights; i <= BridgeState::Schedules; i++) {
+            BridgeState::Resource resource = (BridgeState::Resource)i;
+            if(entry.state && entry.state->isLoaded(resource)) entry.pollQueue.push_back(resource);
+        }
+
+        //nothing loaded yet, check again later
+        if(entry.pollQueue.empty()) {
+            armTimer(entry, bridge);
+            return;
+        }
+        entry.polling = true;
+    }
+
+    pollNext(bridge);
+}
+
+/**
+ *   @brief  Queue the request for the next resource of the running poll
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::pollNext(const string &bridge) {
+    BridgeScheduler::instance()->schedule(bridge, BridgeScheduler::Commands, BridgeScheduler::Background, "",
+                                          boost::bind(&BridgeRegistry::sendPoll, this, bridge));
+}
+
+/**
+ *   @brief  Schedule the next poll of a watched bridge at the fast or slow interval. mutex_ must
+ *           be held.
+ *
+ *   @param  entry is the bridge entry
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::armTimer(Entry &entry, const string &bridge) {
+    if(entry.subscribers.empty() || entry.timerArmed) return;
+
+    bool active = Clock::now() - entry.lastActivity < chrono::milliseconds(ACTIVE_PERIOD);
+    entry.timerArmed = true;
+    WServer::instance()->ioService().schedule(active ? FAST_POLL_INTERVAL : SLOW_POLL_INTERVAL,
+                                              boost::bind(&BridgeRegistry::pollTimer, this, bridge));
+}
+
+/**
+ *   @brief  Timer callback of the poll loop of a bridge
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::pollTimer(const string &bridge) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = entries_.find(bridge);
+        if(it == entries_.end()) return; //released meanwhile
+        it->second.timerArmed = false;
+    }
+    poll(bridge);
+}
+
+/**
+ *   @brief  Send the GET request for the next resource of a poll, creating the bridge's client
+ *           on first use
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ */
+void BridgeRegistry::sendPoll(const string &bridge) {
+    Http::Client *client;
+    string url;
+    {
+        lock_guard<mutex> lock(mutex_);
+        Entry &entry = entries_[bridge];
+        if(!entry.client) {
+            entry.client = new Http::Client(WServer::instance()->ioService());
+            entry.client->setTimeout(2); //2 second timeout of request
+            entry.client->setMaximumResponseSize(BridgeClient::MAX_STREAM_SIZE);
+            //the body is parsed as it arrives instead of being collected in the response
+            entry.client->bodyDataReceived().connect(boost::bind(&BridgeRegistry::pollData, this, bridge, _1));
+            entry.client->done().connect(boost::bind(&BridgeRegistry::handlePoll, this, bridge, _1, _2));
+        }
+        BridgeState::Resource resource = entry.pollQueue.front();
+        entry.parser = make_shared<BridgeParser>(resource);
+        entry.pollVersion = entry.version;
+        client = entry.client;
+        url = entry.url + BridgeState::resourcePath(resource);
+    }
+
+    if(!client->get(url)) {
+        cerr << "BRIDGE: Error polling " << url << "\n";
+        handlePoll(bridge, boost::system::errc::make_error_code(boost::system::errc::invalid_argument), Http::Message());
+    }
+}
+
+/**
+ *   @brief  Function to handle a chunk of the body of a poll
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *   @param  &data is the chunk of the body
+ *
+ *   @return  void
+ */
+void BridgeRegistry::pollData(const string &bridge, const string &data) {
+    shared_ptr<BridgeParser> parser;
+    {
+        lock_guard<mutex> lock(mutex_);
+        parser = entries_[bridge].parser;
+    }
+    //only one poll of a bridge is in flight, so its parser is fed outside of the lock
+    if(parser) parser->feed(data);
+}
+
+/**
+ *   @brief  Function to handle the response for one resource of a poll. A body that differs from
+ *           the last one of that resource is merged into a new snapshot and handed to the watching
+ *           sessions, unless a session changed the snapshot after the request was sent, since the
+ *           body may predate that change. Then the next resource is fetched, or once all are done the next poll is
+ *           scheduled at the fast or slow interval.
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *   @param  *err stores the error code generated by an Http request, null if request was successful
+ *   @param  &response stores the response message generated by the Http request
+ *
+ *   @return  void
+ */
+void BridgeRegistry::handlePoll(const string &bridge, boost::system::error_code err, const Http::Message &response) {
+    if(err) {
+        cerr << "BRIDGE: Error polling " << bridge << ": " << err.message() << "\n";
+    }
+
+    shared_ptr<BridgeParser> parser;
+    {
+        lock_guard<mutex> lock(mutex_);
+        parser.swap(entries_[bridge].parser);
+    }
+
+    shared_ptr<BridgeState> parsed;
+    if(!err && response.status() == 200 && parser) parsed = parser->finish();
+
+    bool finished;
+    {
+        lock_guard<mutex> lock(mutex_);
+        Entry &entry = entries_[bridge];
+        bool stale = entry.version != entry.pollVersion;
+        if(parsed && !stale && parser->getFingerprint() != entry.fingerprints[parser->getResource()]) {
+            shared_ptr<BridgeState> state = entry.state ? make_shared<BridgeState>(*entry.state) : make_shared<BridgeState>();
+            state->merge(*parsed);
+            entry.state = state;
+            entry.fingerprints[parser->getResource()] = parser->getFingerprint();
+            publish(entry, -1);
+        }
+
+        if(!entry.pollQueue.empty()) entry.pollQueue.pop_front();
+        //a failed request ends the poll, the bridge is probably unreachable
+        finished = err || entry.pollQueue.empty() || entry.subscribers.empty();
+        if(finished) {
+            entry.pollQueue.clear();
+            entry.polling = false;
+            armTimer(entry, bridge);
+        }
+    }
+
+    //a bridge nobody watches any more is released once its poll ends
+    if(finished) release(bridge);
+    else pollNext(bridge);
+}
+
+/**
+ *   @brief  Post the snapshot of an entry to its watching sessions. mutex_ must be held.
+ *
+ *   @param  entry is the bridge entry
+ *   @param  except is a subscription that is not called back, -1 for none
+ *
+ *   @return  void
+ */
+void BridgeRegistry::publish(Entry &entry, int except) {
+    for(auto &subscriber : entry.subscribers) {
+        if(subscriber.first == except) continue;
+        WServer::instance()->post(subscriber.second.sessionId,
+                                  boost::bind(&BridgeRegistry::deliver, this, subscriber.first, entry.state));
+    }
+}
+
+/**
+ *   @brief  Run a listener in its session, unless it unsubscribed after the snapshot was posted
+ *
+ *   @param  id is the subscription id
+ *   @param  state is the snapshot to deliver
+ *
+ *   @return  void
+ */
+void BridgeRegistry::deliver(int id, shared_ptr<BridgeState> state) {
+    Listener listener;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = subscriptions_.find(id);
+        if(it == subscriptions_.end()) return;
+        listener = entries_[it->second].subscribers[id].listener;
+    }
+    listener(state);
+}
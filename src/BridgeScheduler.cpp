@@ -0,0 +1,343 @@
+/**
+ *  @file       BridgeScheduler.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application rate limiter for the commands sent to each Bridge
+ *
+ *  @section    DESCRIPTION
+ *
+ *              A Hue bridge handles about 10 light commands and 1 group command per second.
+ *              Accounts can share a bridge, so the budget is enforced for the whole process with
+ *              a token bucket per bridge ip:port:username. Commands wait in a queue per priority
+ *              and are handed back to their session with WServer::post once a token is free.
+ */
+
+#include "BridgeScheduler.h"
+#include <Wt/WServer>
+#include <Wt/WIOService>
+#include <boost/bind.hpp>
+#include <math.h>
+
+using namespace Wt;
+
+/**
+ *   @brief  Returns the scheduler shared by every session of the process
+ *
+ *   @return  BridgeScheduler* the scheduler
+ */
+BridgeScheduler *BridgeScheduler::instance() {
+    static BridgeScheduler scheduler;
+    return &scheduler;
+}
+
+/**
+ *   @brief  BridgeScheduler constructor
+ *
+ */
+BridgeScheduler::BridgeScheduler():
+nextTicket_(0)
+{
+
+}
+
+/**
+ *   @brief  Queue a command for a bridge. The command is started in its session as soon as
+ *           the budget allows and no command of higher priority is waiting for the same budget.
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *   @param  budget is the budget the command is charged against
+ *   @param  priority is the priority of the command
+ *   @param  sessionId is the id of the session that sends the command, empty for requests made
+ *           outside of a session
+ *   @param  start is run in the session once the command may be sent
+ *   @param  *owner is the object start belongs to, it must cancel() before it is deleted
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::schedule(const string &bridge, Budget budget, Priority priority,
+                               const string &sessionId, const boost::function<void ()> &start, const void *owner) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if((int)bridges_.size() > QUEUE_LIMIT) prune(Clock::now());
+
+        Waiting waiting;
+        waiting.budget = budget;
+        waiting.sessionId = sessionId;
+        waiting.start = start;
+        waiting.queued = Clock::now();
+        waiting.owner = owner;
+        getQueue(bridge).waiting[priority].push_back(waiting);
+    }
+    run(bridge);
+}
+
+/**
+ *   @brief  Drop the commands of an object that is being deleted. Waiting commands are removed
+ *           before they take a token, commands already posted to the session are not started
+ *           and their tokens are given back.
+ *
+ *   @param  *owner is the object whose commands are dropped
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::cancel(const void *owner) {
+    if(!owner) return;
+
+    vector<long> posted;
+    {
+        lock_guard<mutex> lock(mutex_);
+        for(auto &bridge : bridges_) {
+            for(int p = 0; p < PriorityCount; p++) {
+                deque<Waiting> &waiting = bridge.second.waiting[p];
+                for(auto it = waiting.begin(); it != waiting.end();) {
+                    if(it->owner == owner) it = waiting.erase(it);
+                    else ++it;
+                }
+            }
+        }
+
+        for(auto &command : granted_) {
+            if(command.second.waiting.owner == owner) posted.push_back(command.first);
+        }
+    }
+
+    for(long ticket : posted) {
+        drop(ticket);
+    }
+}
+
+/**
+ *   @brief  Start a posted command in its session unless its owner cancelled meanwhile
+ *
+ *   @param  ticket is the ticket of the command
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::deliver(long ticket) {
+    boost::function<void ()> start;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = granted_.find(ticket);
+        if(it == granted_.end()) return;
+        start = it->second.waiting.start;
+        granted_.erase(it);
+    }
+    start();
+}
+
+/**
+ *   @brief  Forget a posted command that was cancelled or whose session ended before it could
+ *           start, its token is given back to the commands still waiting
+ *
+ *   @param  ticket is the ticket of the command
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::drop(long ticket) {
+    string bridge;
+    {
+        lock_guard<mutex> lock(mutex_);
+        auto it = granted_.find(ticket);
+        if(it == granted_.end()) return;
+        bridge = it->second.bridge;
+        TokenBucket &bucket = getQueue(bridge).buckets[it->second.waiting.budget];
+        bucket.tokens = min(bucket.capacity, bucket.tokens + 1);
+        granted_.erase(it);
+    }
+    run(bridge);
+}
+
+/**
+ *   @brief  Returns the queue depth and wait times of a bridge
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  Stats the statistics of the bridge since its queue was last dropped
+ *
+ */
+BridgeScheduler::Stats BridgeScheduler::getStats(const string &bridge) {
+    lock_guard<mutex> lock(mutex_);
+    Stats stats = {{0, 0, 0}, 0, 0, 0};
+    auto it = bridges_.find(bridge);
+    if(it == bridges_.end()) return stats;
+
+    BridgeQueue &queue = it->second;
+    for(int i = 0; i < PriorityCount; i++) {
+        stats.queued[i] = queue.waiting[i].size();
+    }
+    stats.granted = queue.granted;
+    stats.averageWait = queue.granted > 0 ? queue.totalWait / queue.granted : 0;
+    stats.maxWait = queue.maxWait;
+    return stats;
+}
+
+/**
+ *   @brief  Returns the queue of a bridge, creating it with full buckets on first use.
+ *           mutex_ must be held.
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  BridgeQueue& the queue of the bridge
+ *
+ */
+BridgeScheduler::BridgeQueue &BridgeScheduler::getQueue(const string &bridge) {
+    auto it = bridges_.find(bridge);
+    if(it != bridges_.end()) return it->second;
+
+    BridgeQueue &queue = bridges_[bridge];
+    Clock::time_point now = Clock::now();
+    queue.buckets[Commands].rate = COMMAND_RATE;
+    queue.buckets[Commands].capacity = COMMAND_RATE;
+    queue.buckets[Groups].rate = GROUP_RATE;
+    queue.buckets[Groups].capacity = GROUP_RATE;
+    for(int i = 0; i < BudgetCount; i++) {
+        queue.buckets[i].tokens = queue.buckets[i].capacity;
+        queue.buckets[i].refilled = now;
+    }
+    queue.timerArmed = false;
+    queue.granted = 0;
+    queue.totalWait = 0;
+    queue.maxWait = 0;
+    return queue;
+}
+
+/**
+ *   @brief  Drop the queues of bridges that have no command waiting and whose buckets are full
+ *           again, a new queue starts the same way. mutex_ must be held.
+ *
+ *   @param  now is the current time
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::prune(Clock::time_point now) {
+    for(auto it = bridges_.begin(); it != bridges_.end();) {
+        BridgeQueue &queue = it->second;
+        bool idle = !queue.timerArmed;
+        for(int p = 0; p < PriorityCount; p++) {
+            if(!queue.waiting[p].empty()) idle = false;
+        }
+        for(int i = 0; i < BudgetCount; i++) {
+            refill(queue.buckets[i], now);
+            if(queue.buckets[i].tokens < queue.buckets[i].capacity) idle = false;
+        }
+
+        if(idle) {
+            it = bridges_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
+
+/**
+ *   @brief  Add the tokens earned since the last refill of a bucket
+ *
+ *   @param  bucket is the bucket to refill
+ *   @param  now is the current time
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::refill(TokenBucket &bucket, Clock::time_point now) {
+    double seconds = chrono::duration<double>(now - bucket.refilled).count();
+    bucket.tokens = min(bucket.capacity, bucket.tokens + seconds * bucket.rate);
+    bucket.refilled = now;
+}
+
+/**
+ *   @brief  Timer callback of a bridge, runs the queue once the next token is due
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::wake(const string &bridge) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        getQueue(bridge).timerArmed = false;
+    }
+    run(bridge);
+}
+
+/**
+ *   @brief  Let through every waiting command of a bridge the budgets allow, highest priority
+ *           first and in order within a priority. If commands are left, a run is scheduled for
+ *           when the next token is due.
+ *
+ *   @param  bridge is the bridge key, ip:port:username
+ *
+ *   @return  void
+ *
+ */
+void BridgeScheduler::run(const string &bridge) {
+    vector<pair<long, string> > posted; // tickets and sessions of the commands let through
+    {
+        lock_guard<mutex> lock(mutex_);
+        BridgeQueue &queue = getQueue(bridge);
+        Clock::time_point now = Clock::now();
+
+        bool blocked[BudgetCount] = {false, false};
+        for(int i = 0; i < BudgetCount; i++) {
+            refill(queue.buckets[i], now);
+        }
+
+        for(int p = 0; p < PriorityCount; p++) {
+            deque<Waiting> &waiting = queue.waiting[p];
+            for(auto it = waiting.begin(); it != waiting.end();) {
+                TokenBucket &bucket = queue.buckets[it->budget];
+                if(blocked[it->budget] || bucket.tokens < 1) {
+                    //keep later commands of this budget behind this one
+                    blocked[it->budget] = true;
+                    ++it;
+                    continue;
+                }
+
+                bucket.tokens -= 1;
+                double wait = chrono::duration<double, milli>(now - it->queued).count();
+                queue.granted++;
+                queue.totalWait += wait;
+                queue.maxWait = max(queue.maxWait, wait);
+
+                long ticket = nextTicket_++;
+                Granted &command = granted_[ticket];
+                command.bridge = bridge;
+                command.waiting = *it;
+                posted.push_back(make_pair(ticket, it->sessionId));
+                it = waiting.erase(it);
+            }
+        }
+
+        //wake up when the first blocked budget has a token again
+        int delay = -1;
+        for(int i = 0; i < BudgetCount; i++) {
+            if(!blocked[i]) continue;
+            TokenBucket &bucket = queue.buckets[i];
+            int due = (int)ceil((1 - bucket.tokens) / bucket.rate * 1000);
+            if(delay < 0 || due < delay) delay = due;
+        }
+        if(delay >= 0 && !queue.timerArmed) {
+            queue.timerArmed = true;
+            WServer::instance()->ioService().schedule(max(delay, 1), boost::bind(&BridgeScheduler::wake, this, bridge));
+        }
+    }
+
+    //commands are sent from their own session, through deliver() so a cancel after posting still holds
+    for(auto &command : posted) {
+        boost::function<void ()> deliver = boost::bind(&BridgeScheduler::deliver, this, command.first);
+        if(command.second == "") {
+            WServer::instance()->ioService().post(deliver);
+        }
+        else {
+            WServer::instance()->post(command.second, deliver, boost::bind(&BridgeScheduler::drop, this, command.first));
+        }
+    }
+}
@@ -28,6 +28,7 @@
 #include <string>
 #include <vector>
 #include "Account.h"
+#include "AccountStore.h"
 #include <Wt/Json/Value>
 #include <Wt/WSplitButton>
 #include <Wt/WPopupMenu>
@@ -186,19 +187,11 @@ void BridgeScreenWidget::registerBridge() {
         string url = "http://" + ip_->text().toUTF8() + ":" + port_->text().toUTF8() + "/api/" + username_->text().toUTF8();
 
         cout << "BRIDGE: Registering at URL " << url << "\n";
-        Wt::Http::Client *client = new Wt::Http::Client(this);
-        client->setTimeout(2); //2 second timeout of request
-        client->setMaximumResponseSize(1000000);
-        client->done().connect(boost::bind(&BridgeScreenWidget::registerBridgeHttp, this, _1, _2));
-
-        if(client->get(url)) {
-            WApplication::instance()->deferRendering();
-        }
-        else {
-            cerr << "BRIDGE: Error in client->get(url) call\n";
-            statusMessage_->setText("Unable to register bridge.");
-            statusMessage_->setHidden(false);
-        }
+        BridgeClient *client = parent_->getBridgeClient(ip_->text().toUTF8(), port_->text().toUTF8());
+        statusMessage_->setText("Connecting to Bridge...");
+        statusMessage_->setHidden(false);
+        //the small config resource is enough to check the bridge answers
+        client->get(url + "/config", this, boost::bind(&BridgeScreenWidget::registerBridgeHttp, this, _1, _2), BridgeScheduler::Interactive);
     }
     else {
         string errmsg = "Invalid input for: ";
@@ -224,14 +217,13 @@ void BridgeScreenWidget::registerBridge() {
  */
 void BridgeScreenWidget::registerBridgeHttp(boost::system::error_code err, const Wt::Http::Message &response)
 {
-    WApplication::instance()->resumeRendering();
     if (!err && response.status() == 200) {
         statusMessage_->setText("Successfully registered!");
         statusMessage_->setHidden(false);
 
-        //add Bridge to user account
-        account_->addBridge(bridgename_->text().toUTF8(), location_->text().toUTF8(), ip_->text().toUTF8(), port_->text().toUTF8(), username_->text().toUTF8());
-        account_->writeFile(); //update credentials file
+        //add Bridge to user account in the account store
+        Bridge bridge(bridgename_->text().toUTF8(), location_->text().toUTF8(), ip_->text().toUTF8(), port_->text().toUTF8(), username_->text().toUTF8());
+        account_->update(boost::bind(static_cast<void (Account::*)(Bridge)>(&Account::addBridge), _1, bridge));
 
         BridgeScreenWidget::updateBridgeTable();
     }
@@ -241,6 +233,7 @@ void BridgeScreenWidget::registerBridgeHttp(boost::system::error_code err, const
         statusMessage_->setText("Unable to connect to Bridge");
         statusMessage_->setHidden(false);
     }
+    WApplication::instance()->triggerUpdate();
 }
 
 /**
@@ -253,8 +246,9 @@ void BridgeScreenWidget::updateBridgeTable(){
     //remove any existing entries
     bridgeTable_->clear();
 
-    //only populate if there are bridges existing
-    if(account_->getNumBridges() > 0) {
+    //only populate if there are bridges existing, the list is shared with the user's other sessions and read without copying
+    shared_ptr<const vector<Bridge> > bridges = account_->getBridges();
+    if(!bridges->empty()) {
         //create new row for headers <tr>
         WTableRow *tableRow = bridgeTable_->insertRow(bridgeTable_->rowCount());
         //table headers <th>
@@ -264,9 +258,9 @@ void BridgeScreenWidget::updateBridgeTable(){
         tableRow->elementAt(3)->addWidget(new Wt::WText("Actions"));
 
 
-        int counter = 0;
-        //populate each row with user account bridges
-        for(auto &bridge : account_->getBridges()) {
+        //populate each row with user account bridges, each button keeps the bridge of its row since
+        //other sessions of the user may add or remove bridges before it is clicked
+        for(const Bridge &bridge : *bridges) {
             //create new row for entry <tr>
             tableRow = bridgeTable_->insertRow(bridgeTable_->rowCount());
 
@@ -278,7 +272,7 @@ void BridgeScreenWidget::updateBridgeTable(){
             tableRow->elementAt(2)->addWidget(new Wt::WText(url));
 
             WPushButton *viewBridgeButton = new WPushButton("View");
-            viewBridgeButton->clicked().connect(boost::bind(&BridgeScreenWidget::viewBridge, this, counter));
+            viewBridgeButton->clicked().connect(boost::bind(&BridgeScreenWidget::viewBridge, this, bridge));
 
             WSplitButton *editBridgeButton = new WSplitButton("Edit");
             WPopupMenu *editBridgePopup = new WPopupMenu();
@@ -287,20 +281,16 @@ void BridgeScreenWidget::updateBridgeTable(){
 
             editBridgeButton->dropDownButton()->setMenu(editBridgePopup);
 
-            editBridgeButton->actionButton()->clicked().connect(boost::bind(&BridgeScreenWidget::editBridge, this, counter));
+            editBridgeButton->actionButton()->clicked().connect(boost::bind(&BridgeScreenWidget::editBridge, this, bridge));
 
-            share->triggered().connect(boost::bind(&BridgeScreenWidget::shareBridgeDialog, this, counter));
+            share->triggered().connect(boost::bind(&BridgeScreenWidget::shareBridgeDialog, this, bridge));
 
             WPushButton *removeBridgeButton = new WPushButton("Remove");
-            removeBridgeButton->clicked().connect(boost::bind(&BridgeScreenWidget::removeBridge, this, counter));
+            removeBridgeButton->clicked().connect(boost::bind(&BridgeScreenWidget::removeBridge, this, bridge));
 
             tableRow->elementAt(3)->addWidget(viewBridgeButton);
             tableRow->elementAt(3)->addWidget(editBridgeButton);
             tableRow->elementAt(3)->addWidget(removeBridgeButton);
-
-
-
-            counter++;
         }
     }
 }
@@ -308,98 +298,123 @@ void BridgeScreenWidget::updateBridgeTable(){
 /**
  *   @brief  View the specific Bridge connected to user account. Returns status message from Http method if the Bridge is unreachable.
  *
- *   @param   pos the position of the Bridge in user account vector to view
+ *   @param   bridge the Bridge of the row that was clicked
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::viewBridge(int pos) {
-    Bridge *bridge = account_->getBridgeAt(pos);
-    string url = "http://" + bridge->getIP() + ":" + bridge->getPort() + "/api/" + bridge->getUsername();
+void BridgeScreenWidget::viewBridge(Bridge bridge) {
+    //another session already keeps this bridge up to date, use its state instead of fetching it again
+    shared_ptr<BridgeState> state = BridgeRegistry::instance()->getPolled(bridge.getKey());
+    if (state) {
+        parent_->setBridgeState(bridge.getKey(), state);
+        showBridge(bridge);
+        return;
+    }
 
-    cout << "BRIDGE: Connecting to URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&BridgeScreenWidget::viewBridgeHttp, this, pos, _1, _2));
+    string url = "http://" + bridge.getIP() + ":" + bridge.getPort() + "/api/" + bridge.getUsername();
 
-    if(client->get(url)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "BRIDGE: Error in client->get(url) call\n";
-    }
+    cout << "BRIDGE: Connecting to URL " << url << "\n";
+    BridgeClient *client = parent_->getBridgeClient(bridge.getIP(), bridge.getPort());
+    statusMessage_->setText("Connecting to Bridge...");
+    statusMessage_->setHidden(false);
+    //only the config is fetched here, the light management pages fetch lights, groups and schedules
+    //the first time they are viewed
+    shared_ptr<BridgeParser> parser = make_shared<BridgeParser>(BridgeState::Config);
+    client->getStreaming(url + "/config", this, boost::bind(&BridgeParser::feed, parser, _1),
+                         boost::bind(&BridgeScreenWidget::viewBridgeHttp, this, bridge, parser, _1, _2), BridgeScheduler::Interactive);
 }
 
 /**
  *   @brief  Function to handle the Http response generated by the Wt Http Client object in the viewBridge() function
  *
- *   @param  pos the position of the Bridge being accessed
+ *   @param  bridge the Bridge being accessed
+ *   @param  parser has read the body of the response
  *   @param  *err stores the error code generated by an Http request, null if request was successful
  *   @param  &response stores the response message generated by the Http request
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::viewBridgeHttp(int pos, boost::system::error_code err, const Wt::Http::Message &response)
+void BridgeScreenWidget::viewBridgeHttp(Bridge bridge, shared_ptr<BridgeParser> parser, boost::system::error_code err, const Wt::Http::Message &response)
 {
-    WApplication::instance()->resumeRendering();
+    shared_ptr<BridgeState> state;
     if (!err && response.status() == 200) {
+        state = BridgeRegistry::instance()->setState(bridge.getIP(), bridge.getPort(), bridge.getUsername(), *parser);
+    }
+    if (state) {
+        parent_->setBridgeState(bridge.getKey(), state);
         statusMessage_->setText("Successfully Connected to Bridge");
         statusMessage_->setHidden(false);
 
-        Bridge *bridge = account_->getBridgeAt(pos);
-        bridge->setJson(response.body());
-
-        WApplication::instance()->setInternalPath("/bridges/" + to_string(pos), true);
+        showBridge(bridge);
     }
     else {
         cerr << "Error: " << err.message() << ", " << response.status() << "\n";
         statusMessage_->setText("Unable to connect to Bridge");
         statusMessage_->setHidden(false);
     }
+    WApplication::instance()->triggerUpdate();
 }
 
 /**
- *   @brief  Opens a WDialog box to edit info for specified Bridge
+ *   @brief  Opens the light management page of a Bridge at its current position in the user
+ *           account, which other sessions may have changed since the table was drawn
  *
- *   @param   pos the position of the Bridge in user account vector to view
+ *   @param   &bridge the Bridge to open
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::editBridge(int pos) {
-    Bridge *bridge = account_->getBridgeAt(pos);
+void BridgeScreenWidget::showBridge(const Bridge &bridge) {
+    int pos = account_->findBridge(bridge);
+    if (pos < 0) {
+        statusMessage_->setText("This Bridge was removed from your account");
+        statusMessage_->setHidden(false);
+        updateBridgeTable();
+        return;
+    }
+    WApplication::instance()->setInternalPath("/bridges/" + to_string(pos), true);
+}
 
+/**
+ *   @brief  Opens a WDialog box to edit info for specified Bridge
+ *
+ *   @param   bridge the Bridge of the row that was clicked
+ *
+ *   @return  void
+ *
+ */
+void BridgeScreenWidget::editBridge(Bridge bridge) {
     bridgeEditDialog_ = new WDialog("Edit Bridge"); // title
 
     new WLabel("Bridge Name: ", bridgeEditDialog_->contents());
     bridgeEditName_ = new WLineEdit(bridgeEditDialog_->contents());
-    bridgeEditName_->setValueText(bridge->getName());
+    bridgeEditName_->setValueText(bridge.getName());
     bridgeEditName_->setValidator(stringValidator_);
     new WBreak(bridgeEditDialog_->contents());
 
     new WLabel("Bridge Location: ", bridgeEditDialog_->contents());
     bridgeEditLocation_ = new WLineEdit(bridgeEditDialog_->contents());
-    bridgeEditLocation_->setValueText(bridge->getLocation());
+    bridgeEditLocation_->setValueText(bridge.getLocation());
     bridgeEditLocation_->setValidator(stringValidator_);
     new WBreak(bridgeEditDialog_->contents());
 
     new WLabel("Bridge IP: ", bridgeEditDialog_->contents());
     bridgeEditIP_ = new WLineEdit(bridgeEditDialog_->contents());
-    bridgeEditIP_->setValueText(bridge->getIP());
+    bridgeEditIP_->setValueText(bridge.getIP());
     bridgeEditIP_->setValidator(ipValidator_);
     new WBreak(bridgeEditDialog_->contents());
 
     new WLabel("Bridge Port: ", bridgeEditDialog_->contents());
     bridgeEditPort_ = new WLineEdit(bridgeEditDialog_->contents());
-    bridgeEditPort_->setValueText(bridge->getPort());
+    bridgeEditPort_->setValueText(bridge.getPort());
     bridgeEditPort_->setValidator(portValidator_);
     new WBreak(bridgeEditDialog_->contents());
 
     new WLabel("Bridge Username: ", bridgeEditDialog_->contents());
     bridgeEditUsername_ = new WLineEdit(bridgeEditDialog_->contents());
-    bridgeEditUsername_->setValueText(bridge->getUsername());
+    bridgeEditUsername_->setValueText(bridge.getUsername());
     bridgeEditUsername_->setValidator(stringValidator_);
     new WBreak(bridgeEditDialog_->contents());
 
@@ -412,19 +427,20 @@ void BridgeScreenWidget::editBridge(int pos) {
     cancel->clicked().connect(bridgeEditDialog_, &WDialog::reject);
 
     // when the user is finished, call the updateBridge function
-    bridgeEditDialog_->finished().connect(boost::bind(&BridgeScreenWidget::updateBridge, this, pos));
+    bridgeEditDialog_->finished().connect(boost::bind(&BridgeScreenWidget::updateBridge, this, bridge));
+    bridgeEditDialog_->finished().connect(boost::bind(&BridgeScreenWidget::closeDialog, this, bridgeEditDialog_));
     bridgeEditDialog_->show();
 }
 
 /**
  *   @brief  Opens a WDialog box to share specified Bridge
  *
- *   @param   pos the position of the Bridge in user account vector to view
+ *   @param   bridge the Bridge of the row that was clicked
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::shareBridgeDialog(int pos) {
+void BridgeScreenWidget::shareBridgeDialog(Bridge bridge) {
 
 
 
@@ -445,44 +461,28 @@ void BridgeScreenWidget::shareBridgeDialog(int pos) {
     cancel->clicked().connect(bridgeShareDialog_, &WDialog::reject);
 
     // when the user is finished, call the shareBridge function
-    bridgeShareDialog_->finished().connect(boost::bind(&BridgeScreenWidget::shareBridge, this, pos));
+    bridgeShareDialog_->finished().connect(boost::bind(&BridgeScreenWidget::shareBridge, this, bridge));
+    bridgeShareDialog_->finished().connect(boost::bind(&BridgeScreenWidget::closeDialog, this, bridgeShareDialog_));
 
     bridgeShareDialog_->show();
 }
 /**
  *   @brief  share specific Bridge connected to user account to another user account. Returns status message from Http method if the Bridge is unreachable.
  *
- *   @param   pos the position of the Bridge in user account vector to update
+ *   @param   bridge the Bridge to share
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::shareBridge(int pos) {
+void BridgeScreenWidget::shareBridge(Bridge bridge) {
     // if user clicked "cancel" in dialog box, don't do anything
     if (bridgeShareDialog_->result() == WDialog::DialogCode::Rejected)
         return;
 
-        ofstream outFile;
-        ifstream inFile;
-        string str;
-        string filename = "credentials/" + bridgeShareUserid_->text().toUTF8() + ".txt";
-
-        inFile.open(filename.c_str()); // opens username.txt
-
-
-        Bridge *bridge = account_->getBridgeAt(pos);
-
-    if(bridgeShareUserid_->validate() == 2 && inFile) {
-        inFile.close();
-        outFile.open(filename.c_str(), ios_base::app); // opens username.txt
-
-        outFile << bridge->getName() << ", "
-        << bridge->getLocation() << ", "
-        << bridge->getIP() << ", "
-        << bridge->getPort() << ", "
-        << bridge->getUsername() << "\n";
-
-        string successmsg = "Bridge share successful, next time they log in " + bridgeShareUserid_->text().toUTF8() + " will be able to control this bridge";
+    // adds the bridge to the other account, fails if there is no such account
+    if(bridgeShareUserid_->validate() == 2 &&
+       AccountStore::instance()->addBridge(bridgeShareUserid_->text().toUTF8(), bridge)) {
+        string successmsg = "Bridge share successful, " + bridgeShareUserid_->text().toUTF8() + " is now able to control this bridge";
 
         statusMessage_->setText(successmsg);
         statusMessage_->removeStyleClass("error");
@@ -501,12 +501,12 @@ void BridgeScreenWidget::shareBridge(int pos) {
 /**
  *   @brief  Edit specific Bridge connected to user account. Returns status message from Http method if the Bridge is unreachable.
  *
- *   @param   pos the position of the Bridge in user account vector to update
+ *   @param   bridge the Bridge to update, as it was when its dialog opened
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::updateBridge(int pos) {
+void BridgeScreenWidget::updateBridge(Bridge bridge) {
     // if user clicked "cancel" in dialog box, don't do anything
     if (bridgeEditDialog_->result() == WDialog::DialogCode::Rejected)
         return;
@@ -520,17 +520,14 @@ void BridgeScreenWidget::updateBridge(int pos) {
         string url = "http://" + bridgeEditIP_->text().toUTF8() + ":" + bridgeEditPort_->text().toUTF8() + "/api/" + bridgeEditUsername_->text().toUTF8();
 
         cout << "BRIDGE: Connecting to URL " << url << "\n";
-        Wt::Http::Client *client = new Wt::Http::Client(this);
-        client->setTimeout(2); //2 second timeout of request
-        client->setMaximumResponseSize(1000000);
-        client->done().connect(boost::bind(&BridgeScreenWidget::updateBridgeHttp, this, pos, _1, _2));
-
-        if(client->get(url)) {
-            WApplication::instance()->deferRendering();
-        }
-        else {
-            cerr << "BRIDGE: Error in client->get(url) call\n";
-        }
+        BridgeClient *client = parent_->getBridgeClient(bridgeEditIP_->text().toUTF8(), bridgeEditPort_->text().toUTF8());
+        statusMessage_->setText("Connecting to Bridge...");
+        statusMessage_->setHidden(false);
+        //the dialog is gone by the time the bridge answers, so the new values travel with the request
+        client->get(url + "/config", this, boost::bind(&BridgeScreenWidget::updateBridgeHttp, this, bridge,
+                                                       bridgeEditName_->text().toUTF8(), bridgeEditLocation_->text().toUTF8(),
+                                                       bridgeEditIP_->text().toUTF8(), bridgeEditPort_->text().toUTF8(),
+                                                       bridgeEditUsername_->text().toUTF8(), _1, _2), BridgeScheduler::Interactive);
     }
     else {
         string errmsg = "Error updating Bridge: Invalid input for: ";
@@ -548,28 +545,31 @@ void BridgeScreenWidget::updateBridge(int pos) {
 /**
  *   @brief  Function to handle the Http response generated by the Wt Http Client object in the updateBridge() function
  *
- *   @param  pos the position of the Bridge being accessed
+ *   @param  old the Bridge being updated, as it was when its dialog opened
+ *   @param  name is the new name of the Bridge
+ *   @param  location is the new location of the Bridge
+ *   @param  ip is the new IP address of the Bridge
+ *   @param  port is the new port of the Bridge
+ *   @param  username is the new username on the Bridge
  *   @param  *err stores the error code generated by an Http request, null if request was successful
  *   @param  &response stores the response message generated by the Http request
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::updateBridgeHttp(int pos, boost::system::error_code err, const Wt::Http::Message &response)
+void BridgeScreenWidget::updateBridgeHttp(Bridge old, string name, string location, string ip, string port, string username,
+                                          boost::system::error_code err, const Wt::Http::Message &response)
 {
-    WApplication::instance()->resumeRendering();
     if (!err && response.status() == 200) {
         statusMessage_->setText("Successfully updated Bridge.");
         statusMessage_->setHidden(false);
 
-        Bridge *bridge = account_->getBridgeAt(pos);
-        bridge->setName(bridgeEditName_->text().toUTF8());
-        bridge->setLocation(bridgeEditLocation_->text().toUTF8());
-        bridge->setIP(bridgeEditIP_->text().toUTF8());
-        bridge->setPort(bridgeEditPort_->text().toUTF8());
-        bridge->setUsername(bridgeEditUsername_->text().toUTF8());
-
-        account_->writeFile();
+        //the Bridge is found by its old details, other sessions may have moved it meanwhile
+        Bridge updated(name, location, ip, port, username);
+        account_->update([old, updated](Account &account) {
+            int index = account.findBridge(old);
+            if(index >= 0) account.setBridgeAt(index, updated);
+        });
         BridgeScreenWidget::updateBridgeTable();
     }
     else {
@@ -577,28 +577,42 @@ void BridgeScreenWidget::updateBridgeHttp(int pos, boost::system::error_code err
         statusMessage_->setText("Error updating Bridge: Invalid connection info.");
         statusMessage_->setHidden(false);
     }
+    WApplication::instance()->triggerUpdate();
+}
+
+/**
+ *   @brief  Close dialog function, deletes a dialog once its finished handler has run
+ *
+ *   @param  *dialog is the dialog that finished
+ *
+ *   @return  void
+ */
+void BridgeScreenWidget::closeDialog(WDialog *dialog) {
+    delete dialog;
 }
 
 /**
  *   @brief  Removes a Bridge from user account
  *
- *   @param   pos the position of the Bridge in the vector to remove
+ *   @param   bridge the Bridge of the row that was clicked
  *
  *   @return  void
  *
  */
-void BridgeScreenWidget::removeBridge(int pos){
-    if(account_->getNumBridges() == 0) {
-        statusMessage_->setText("No bridges to delete!");
-        statusMessage_->setHidden(false);
-    }
-    else {
-        statusMessage_->setText("Bridge successfully removed!");
-        statusMessage_->setHidden(false);
-        account_->removeBridgeAt(pos);
-        account_->writeFile(); //update credentials file
-        BridgeScreenWidget::updateBridgeTable();
-    }
+void BridgeScreenWidget::removeBridge(Bridge bridge){
+    //the Bridge is found by its details, other sessions may have moved or removed it meanwhile
+    bool removed = false;
+    account_->update([bridge, &removed](Account &account) {
+        int index = account.findBridge(bridge);
+        if(index >= 0) {
+            account.removeBridgeAt(index);
+            removed = true;
+        }
+    });
+
+    statusMessage_->setText(removed ? "Bridge successfully removed!" : "No such bridge to delete!");
+    statusMessage_->setHidden(false);
+    BridgeScreenWidget::updateBridgeTable();
 }
 
 
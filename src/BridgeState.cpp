@@ -0,0 +1,432 @@
+/**
+ *  @file       BridgeState.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application typed model of a Bridge's lights, groups, and schedules
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class stores the state of a Bridge as returned by the Hue API. The JSON body
+ *              is parsed once, by BridgeParser, into Light, Group, and Schedule objects keyed by
+ *              their number so that the tables and dialogs can share them without re-parsing the JSON.
+ */
+
+#include "BridgeState.h"
+#include "BridgeParser.h"
+#include <stdlib.h>
+#include <sstream>
+#include <boost/lexical_cast.hpp>
+
+/**
+ *   @brief  BridgeState constructor
+ *
+ */
+BridgeState::BridgeState() {
+    for(int i = 0; i < AllResources; i++) {
+        loaded_[i] = false;
+    }
+}
+
+/**
+ *   @brief  BridgeState destructor
+ *
+ */
+BridgeState::~BridgeState() {
+
+}
+
+/**
+ *   @brief  Parse the full /api/<username> JSON body of a Bridge into typed objects. Bodies
+ *           received in chunks are read with BridgeParser directly.
+ *
+ *   @param  json is the JSON body returned by the Hue API
+ *
+ *   @return  bool true if the body was parsed, false if it was not valid JSON
+ */
+bool BridgeState::parse(const string &json) {
+    BridgeParser parser;
+    parser.feed(json);
+    shared_ptr<BridgeState> parsed = parser.finish();
+    if(!parsed) return false;
+
+    merge(*parsed);
+    return true;
+}
+
+/**
+ *   @brief  Take the resources loaded in another state, e.g. one filled from /lights alone,
+ *           and keep the rest of this state as it is
+ *
+ *   @param  &from is the state holding the newer resources
+ *
+ *   @return  void
+ */
+void BridgeState::merge(const BridgeState &from) {
+    if(from.loaded_[Lights]) lights_ = from.lights_;
+    if(from.loaded_[Groups]) groups_ = from.groups_;
+    if(from.loaded_[Schedules]) schedules_ = from.schedules_;
+    if(from.loaded_[Config]) {
+        name_ = from.name_;
+        modelid_ = from.modelid_;
+        swversion_ = from.swversion_;
+        apiversion_ = from.apiversion_;
+        mac_ = from.mac_;
+    }
+
+    for(int i = 0; i < AllResources; i++) {
+        if(from.loaded_[i]) {
+            loaded_[i] = true;
+            fetched_[i] = from.fetched_[i];
+        }
+    }
+}
+
+/**
+ *   @brief  Check if a resource was fetched recently
+ *
+ *   @param  resource is the resource to check
+ *   @param  maxAge is the age in milliseconds after which the resource is stale
+ *
+ *   @return  bool true if the resource is loaded and younger than maxAge
+ */
+bool BridgeState::isFresh(Resource resource, int maxAge) {
+    return loaded_[resource] && chrono::steady_clock::now() - fetched_[resource] < chrono::milliseconds(maxAge);
+}
+
+/**
+ *   @brief  Returns the path of a resource below /api/<username>
+ *
+ *   @param  resource is the resource
+ *
+ *   @return  string the path, e.g. /lights, empty for AllResources
+ */
+string BridgeState::resourcePath(Resource resource) {
+    switch(resource) {
+        case Lights: return "/lights";
+        case Groups: return "/groups";
+        case Schedules: return "/schedules";
+        case Config: return "/config";
+        default: return "";
+    }
+}
+
+/**
+ *   @brief  Fold the response of a successful PUT, POST, or DELETE into the stored state so
+ *           that the Bridge does not need to be fetched again. The Hue API answers with an
+ *           array of results such as [{"success":{"/lights/3/state/bri":200}}].
+ *
+ *   @param  resource is the path of the request below /api/<username>, e.g. /groups/1/action
+ *   @param  request is the JSON body that was sent with the request
+ *   @param  response is the JSON body returned by the Hue API
+ *
+ *   @return  bool true if every result was applied, false if the state must be refreshed
+ */
+bool BridgeState::applyResponse(const string &resource, const string &request, const string &response) {
+    Json::Value results;
+    try {
+        Json::parse(response, results);
+    }
+    catch (Json::ParseError &e) {
+        cerr << "BRIDGE: Unable to parse response JSON: " << e.what() << "\n";
+        return false;
+    }
+    if(results.type() != Json::ArrayType) return false;
+
+    bool applied = true;
+    const Json::Array &resultArray = results;
+    for(const Json::Value &result : resultArray) {
+        if(result.type() != Json::ObjectType) {
+            applied = false;
+            continue;
+        }
+        const Json::Object &resultObject = result;
+
+        if(resultObject.type("error") == Json::ObjectType) {
+            const Json::Object &error = resultObject.get("error");
+            cerr << "BRIDGE: " << error.get("address").orIfNull("") << " "
+                 << error.get("description").orIfNull("") << "\n";
+            applied = false;
+        }
+        else if(resultObject.type("success") == Json::StringType) {
+            // DELETE: {"success":"/groups/1 deleted"}
+            applied = applyDeleted(resultObject.get("success").orIfNull("").toUTF8()) && applied;
+        }
+        else if(resultObject.type("success") == Json::ObjectType) {
+            const Json::Object &success = resultObject.get("success");
+            if(success.type("id") != Json::NullType) {
+                // POST: {"success":{"id":"2"}}, the new entry is built from the request body
+                Json::Object data;
+                try {
+                    Json::parse(request, data);
+                }
+                catch (Json::ParseError &e) {
+                    applied = false;
+                    continue;
+                }
+                string id = success.type("id") == Json::StringType ?
+                            success.get("id").orIfNull("").toUTF8() :
+                            boost::lexical_cast<string>((int)success.get("id"));
+                applied = applyCreated(resource, id, data) && applied;
+            }
+            else {
+                // PUT: {"success":{"/lights/3/state/bri":200}}
+                for(auto &entry : success) {
+                    applied = applySuccess(entry.first, entry.second) && applied;
+                }
+            }
+        }
+        else {
+            applied = false;
+        }
+    }
+    return applied;
+}
+
+/**
+ *   @brief  Apply a single success path of a PUT response to the stored state
+ *
+ *   @param  path is the address that was changed, e.g. /lights/3/state/bri
+ *   @param  value is the new value of the address
+ *
+ *   @return  bool true if the path was applied, false if it is not tracked by the state
+ */
+bool BridgeState::applySuccess(const string &path, const Json::Value &value) {
+    vector<string> parts = splitPath(path);
+    if(parts.size() < 3) return false;
+
+    int num = parseKey(parts[1]);
+    if(parts[0] == "lights") {
+        Light *light = getLight(num);
+        if(!light) return false;
+        if(parts.size() == 3 && parts[2] == "name") {
+            light->setName(value.toString());
+            return true;
+        }
+        if(parts.size() == 4 && parts[2] == "state") return applyLightState(light, parts[3], value);
+    }
+    else if(parts[0] == "groups") {
+        Group *group = getGroup(num);
+        if(!group) return false;
+        if(parts.size() == 3 && parts[2] == "name") {
+            group->setName(value.toString());
+            return true;
+        }
+        if(parts.size() == 3 && parts[2] == "lights" && value.type() == Json::ArrayType) {
+            const Json::Array &lights = value;
+            group->clearLights();
+            for(const Json::Value &lightNum : lights) {
+                //a key that is not a number would be stored as light 65535
+                int light = parseKey(lightNum.orIfNull("").toUTF8());
+                if(light >= 0) group->addLight(light);
+            }
+            return true;
+        }
+        if(parts.size() == 4 && parts[2] == "action") return applyGroupAction(group, parts[3], value);
+    }
+    else if(parts[0] == "schedules") {
+        Schedule *schedule = getSchedule(num);
+        if(!schedule || parts.size() != 3) return false;
+        if(parts[2] == "name") schedule->setName(value.toString());
+        else if(parts[2] == "description") schedule->setDescription(value.toString());
+        else if(parts[2] == "time" || parts[2] == "localtime") schedule->setTime(value.toString());
+        else if(parts[2] == "command" && value.type() == Json::ObjectType) schedule->setCommand(value);
+        else if(parts[2] != "status" && parts[2] != "autodelete") return false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ *   @brief  Apply a changed state attribute to a Light
+ *
+ *   @param  light is the Light to update
+ *   @param  attr is the name of the state attribute, e.g. bri
+ *   @param  value is the new value of the attribute
+ *
+ *   @return  bool true if the attribute was applied
+ */
+bool BridgeState::applyLightState(Light *light, const string &attr, const Json::Value &value) {
+    if(attr == "on") light->setOn(value);
+    else if(attr == "bri") light->setBri(value);
+    else if(attr == "hue") {
+        light->setHue(value);
+        light->setColormode("hs");
+    }
+    else if(attr == "sat") {
+        light->setSat(value);
+        light->setColormode("hs");
+    }
+    else if(attr == "ct") {
+        light->setCt(value);
+        light->setColormode("ct");
+    }
+    else if(attr == "xy" && value.type() == Json::ArrayType) {
+        const Json::Array &xy = value;
+        if(xy.size() != 2) return false;
+        light->setX(xy[0]);
+        light->setY(xy[1]);
+        light->setColormode("xy");
+    }
+    else if(attr == "alert") light->setAlert(value.toString());
+    else if(attr == "effect") light->setEffect(value.toString());
+    else if(attr != "transitiontime") return false;
+    return true;
+}
+
+/**
+ *   @brief  Apply a changed action attribute to a Group and the Lights that belong to it
+ *
+ *   @param  group is the Group to update
+ *   @param  attr is the name of the action attribute, e.g. bri
+ *   @param  value is the new value of the attribute
+ *
+ *   @return  bool true if the attribute was applied
+ */
+bool BridgeState::applyGroupAction(Group *group, const string &attr, const Json::Value &value) {
+    if(attr == "on") group->setOn(value);
+    else if(attr == "bri") group->setBri(value);
+    else if(attr == "hue") group->setHue(value);
+    else if(attr == "sat") group->setSat(value);
+    else if(attr == "ct") group->setCt(value);
+    else if(attr == "xy" && value.type() == Json::ArrayType) {
+        const Json::Array &xy = value;
+        if(xy.size() != 2) return false;
+        group->setX(xy[0]);
+        group->setY(xy[1]);
+    }
+    else if(attr == "alert") group->setAlert(value.toString());
+    else if(attr == "effect") group->setEffect(value.toString());
+    else if(attr == "transitiontime") return true;
+    else return false;
+
+    // a group action is applied by the bridge to every light in the group
+    for(int lightNum : group->getLights()) {
+        Light *light = getLight(lightNum);
+        if(light) applyLightState(light, attr, value);
+    }
+    return true;
+}
+
+/**
+ *   @brief  Add an entry created by a POST request to the stored state
+ *
+ *   @param  resource is the path the POST was sent to, e.g. /groups
+ *   @param  id is the number assigned to the new entry by the Bridge
+ *   @param  data is the JSON body that was sent with the POST
+ *
+ *   @return  bool true if the entry was added
+ */
+bool BridgeState::applyCreated(const string &resource, const string &id, const Json::Object &data) {
+    int num = parseKey(id);
+    if(num < 0) return false;
+    if(resource == "/groups") {
+        groups_.erase(num);
+        groups_.insert(make_pair(num, Group(id, data)));
+        return true;
+    }
+    if(resource == "/schedules") {
+        schedules_.erase(num);
+        schedules_.insert(make_pair(num, Schedule(id, data)));
+        return true;
+    }
+    return false;
+}
+
+/**
+ *   @brief  Remove an entry deleted by a DELETE request from the stored state
+ *
+ *   @param  path is the success message of the Bridge, e.g. "/groups/1 deleted"
+ *
+ *   @return  bool true if the entry was removed
+ */
+bool BridgeState::applyDeleted(const string &path) {
+    vector<string> parts = splitPath(path.substr(0, path.find(' ')));
+    if(parts.size() != 2) return false;
+
+    int num = parseKey(parts[1]);
+    if(parts[0] == "lights") {
+        lights_.erase(num);
+        for(auto &entry : groups_) {
+            Group &group = entry.second;
+            vector<uint16_t> lights = group.getLights();
+            group.clearLights();
+            for(int lightNum : lights) {
+                if(lightNum != num) group.addLight(lightNum);
+            }
+        }
+    }
+    else if(parts[0] == "groups") groups_.erase(num);
+    else if(parts[0] == "schedules") schedules_.erase(num);
+    else return false;
+    return true;
+}
+
+/**
+ *   @brief  Returns a pointer to the Light with the given number
+ *
+ *   @param  num the number key of the Light in the Hue API
+ *
+ *   @return pointer to the Light, 0 if the Bridge has no such Light
+ */
+Light *BridgeState::getLight(int num) {
+    auto it = lights_.find(num);
+    return it == lights_.end() ? 0 : &it->second;
+}
+
+/**
+ *   @brief  Returns a pointer to the Group with the given number
+ *
+ *   @param  num the number key of the Group in the Hue API
+ *
+ *   @return pointer to the Group, 0 if the Bridge has no such Group
+ */
+Group *BridgeState::getGroup(int num) {
+    auto it = groups_.find(num);
+    return it == groups_.end() ? 0 : &it->second;
+}
+
+/**
+ *   @brief  Returns a pointer to the Schedule with the given number
+ *
+ *   @param  num the number key of the Schedule in the Hue API
+ *
+ *   @return pointer to the Schedule, 0 if the Bridge has no such Schedule
+ */
+Schedule *BridgeState::getSchedule(int num) {
+    auto it = schedules_.find(num);
+    return it == schedules_.end() ? 0 : &it->second;
+}
+
+/**
+ *   @brief  Splits a Hue API address such as /lights/3/state/bri into its parts
+ *
+ *   @param  path the address to split
+ *
+ *   @return vector of the non-empty parts of the address
+ */
+vector<string> BridgeState::splitPath(const string &path) {
+    vector<string> parts;
+    stringstream ss(path);
+    string part;
+    while(getline(ss, part, '/')) {
+        if(!part.empty()) parts.push_back(part);
+    }
+    return parts;
+}
+
+/**
+ *   @brief  Converts a Hue API key such as "12" into its number
+ *
+ *   @param  key the string key of a light, group, or schedule
+ *
+ *   @return the number of the key, -1 if the key is not numeric
+ */
+int BridgeState::parseKey(const string &key) {
+    if(key.empty()) return -1;
+    char *end;
+    long num = strtol(key.c_str(), &end, 10);
+    if(*end != '\0' || num < 0) return -1;
+    return (int)num;
+}
@@ -10,6 +10,14 @@
  *
  *              This is a helper class used to convert colour values from RGB format
  *              to the XY format, RGB to the Hue Sat Bri format, or from XY to RGB format.
+ *              Colours are returned by value so converting never allocates, and each
+ *              conversion has a batch form that fills an array of colours in one call.
+ *              The sRGB gamma steps are read from tables built once at start up instead
+ *              of calling pow() per channel. Where the compiler offers SSE2 the batch forms
+ *              convert four colours at a time, gamma steps included, as SSE2 has no gather
+ *              to read the tables the gamma curves are polynomials there.
+ *              Colour temperatures are read from tables of the white point of every
+ *              mired the lights support.
  */
 
 #include "ColourConvert.h"
@@ -18,9 +26,210 @@
 #include <stdlib.h>
 #include <string>
 #include <unistd.h>
+#include <unordered_map>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
+namespace {
+
+// sRGB gamma tables, exact for the 8-bit decode and linearly interpolated for the encode
+struct GammaTables {
+    float decode[256]; // linear value of each 0-255 channel value
+    float encode[ColourConvert::GAMMA_ENCODE_STEPS + 2]; // sRGB value 0-1 at each step of linear 0-1, padded for interpolation
+
+    GammaTables() {
+        for (int i = 0; i < 256; i++) {
+            float c = i / 255.0f;
+            decode[i] = (c > 0.04045f) ? pow((c + 0.055f) / (1.0f + 0.055f), 2.4f) : (c / 12.92f);
+        }
+        for (int i = 0; i <= ColourConvert::GAMMA_ENCODE_STEPS; i++) {
+            float c = (float)i / ColourConvert::GAMMA_ENCODE_STEPS;
+            encode[i] = c <= 0.0031308f ? 12.92f * c : (1.0f + 0.055f) * pow(c, (1.0f / 2.4f)) - 0.055f;
+        }
+        encode[ColourConvert::GAMMA_ENCODE_STEPS + 1] = encode[ColourConvert::GAMMA_ENCODE_STEPS];
+    }
+};
+
+const GammaTables gammaTables;
+
+#ifdef __SSE2__
+static_assert(sizeof(struct rgb) == 4 * sizeof(float), "the batch forms load and store a struct rgb as one vector");
+
+/**
+ *   @brief  Polynomial of four values, coefficients from the constant term up
+ */
+template <int N>
+inline __m128 polynomial4(__m128 t, const float (&coefficients)[N])
+{
+    __m128 p = _mm_set1_ps(coefficients[N - 1]);
+    for (int i = N - 2; i >= 0; i--) {
+        p = _mm_add_ps(_mm_mul_ps(p, t), _mm_set1_ps(coefficients[i]));
+    }
+    return p;
+}
+
+/**
+ *   @brief  sRGB to linear gamma step of four channels. The curve is fitted in the square root
+ *           of the channel, within 0.000001 of pow() for channels 0-255.
+ *
+ *   @param  c is four colour channels 0-255
+ *
+ *   @return __m128 the linear channels 0-1
+ */
+inline __m128 gammaDecode4(__m128 c)
+{
+    // fitted on sqrt(0.04045) to 1, centred on 0.600560927
+    static const float curve[] = {0.106954614f, 0.741733698f, 2.11783055f, 3.07598938f,
+                                  2.23318008f, 0.601929476f, -0.0349107267f};
+    const __m128 knee = _mm_set1_ps(0.04045f);
+
+    __m128 u = _mm_mul_ps(c, _mm_set1_ps(1.0f / 255.0f));
+    __m128 t = _mm_sqrt_ps(_mm_max_ps(u, knee));
+    __m128 curved = polynomial4(_mm_sub_ps(t, _mm_set1_ps(0.600560927f)), curve);
+    __m128 linear = _mm_mul_ps(u, _mm_set1_ps(1.0f / 12.92f));
+
+    __m128 dark = _mm_cmple_ps(u, knee);
+    return _mm_or_ps(_mm_and_ps(dark, linear), _mm_andnot_ps(dark, curved));
+}
+
+/**
+ *   @brief  Linear to sRGB gamma step of four channels. The curve is fitted in the fourth root
+ *           of the channel, within 0.003 of pow() on the 0-255 scale.
+ *
+ *   @param  c is four linear colour channels
+ *
+ *   @return __m128 the sRGB channels, channels of 1 and above give 1 and NaN gives 0
+ */
+inline __m128 gammaEncode4(__m128 c)
+{
+    // fitted on 0.0031308^(1/4) to 1, centred on 0.618272516
+    static const float curve[] = {0.418395644f, 1.27610327f, 0.687299624f, -0.122917874f,
+                                  0.0787414457f, -0.0627589915f};
+    const __m128 knee = _mm_set1_ps(0.0031308f);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    __m128 t = _mm_sqrt_ps(_mm_sqrt_ps(_mm_min_ps(_mm_max_ps(c, knee), one)));
+    __m128 curved = polynomial4(_mm_sub_ps(t, _mm_set1_ps(0.618272516f)), curve);
+    __m128 linear = _mm_mul_ps(c, _mm_set1_ps(12.92f));
+
+    __m128 dark = _mm_cmple_ps(c, knee);
+    __m128 bright = _mm_cmpge_ps(c, one);
+    __m128 s = _mm_or_ps(_mm_and_ps(dark, linear), _mm_andnot_ps(dark, curved));
+    s = _mm_or_ps(_mm_and_ps(bright, one), _mm_andnot_ps(bright, s));
+    // the NaN of a zero y ends up black as in the single colour converter
+    return _mm_and_ps(_mm_cmpord_ps(c, c), s);
+}
+#endif
+
+// white point of every whole mired from CT_MIN to CT_MAX, as full brightness RGB and as xy
+struct ColourTemperatureTables {
+    struct rgb rgb[ColourConvert::CT_MAX - ColourConvert::CT_MIN + 2];
+    struct xy xy[ColourConvert::CT_MAX - ColourConvert::CT_MIN + 2];
+
+    ColourTemperatureTables() {
+        for (int i = 0; i <= ColourConvert::CT_MAX - ColourConvert::CT_MIN; i++) {
+            double kelvin = 1000000.0 / (ColourConvert::CT_MIN + i);
+
+            // black body colour fitted over 1000 K to 40000 K, in steps of 100 K
+            double t = kelvin / 100.0;
+            double r = t <= 66 ? 255 : 329.698727446 * pow(t - 60, -0.1332047592);
+            double g = t <= 66 ? 99.4708025861 * log(t) - 161.1195681661 : 288.1221695283 * pow(t - 60, -0.0755148492);
+            double b = t >= 66 ? 255 : (t <= 19 ? 0 : 138.5177312231 * log(t - 10) - 305.0447927307);
+            rgb[i].r = (float)fmin(fmax(r, 0), 255);
+            rgb[i].g = (float)fmin(fmax(g, 0), 255);
+            rgb[i].b = (float)fmin(fmax(b, 0), 255);
+            rgb[i].brightness = 254;
+
+            // cubic fit of the Planckian locus
+            double k3 = kelvin * kelvin * kelvin, k2 = kelvin * kelvin;
+            double x = kelvin <= 4000 ? -0.2661239e9 / k3 - 0.2343589e6 / k2 + 0.8776956e3 / kelvin + 0.179910
+                                      : -3.0258469e9 / k3 + 2.1070379e6 / k2 + 0.2226347e3 / kelvin + 0.240390;
+            double y;
+            if (kelvin <= 2222)
+                y = -1.1063814 * x * x * x - 1.34811020 * x * x + 2.18555832 * x - 0.20219683;
+            else if (kelvin <= 4000)
+                y = -0.9549476 * x * x * x - 1.37418593 * x * x + 2.09137015 * x - 0.16748867;
+            else
+                y = 3.0817580 * x * x * x - 5.87338670 * x * x + 3.75112997 * x - 0.37001483;
+            xy[i].x = (float)x;
+            xy[i].y = (float)y;
+            xy[i].brightness = 254;
+        }
+        rgb[ColourConvert::CT_MAX - ColourConvert::CT_MIN + 1] = rgb[ColourConvert::CT_MAX - ColourConvert::CT_MIN];
+        xy[ColourConvert::CT_MAX - ColourConvert::CT_MIN + 1] = xy[ColourConvert::CT_MAX - ColourConvert::CT_MIN];
+    }
+};
+
+const ColourTemperatureTables ctTables;
+
+/**
+ *   @brief  Position of a colour temperature in the tables
+ *
+ *   @param  ct is the colour temperature in mired, clamped to the range of the lights
+ *   @param  &frac is set to the distance past the returned entry, 0-1
+ *
+ *   @return int index of the table entry at or below ct
+ */
+int ctIndex(float ct, float &frac)
+{
+    if (!(ct > ColourConvert::CT_MIN)) ct = ColourConvert::CT_MIN;
+    if (ct > ColourConvert::CT_MAX) ct = ColourConvert::CT_MAX;
+    float pos = ct - ColourConvert::CT_MIN;
+    int i = (int)pos;
+    frac = pos - i;
+    return i;
+}
+
+}
+
+constexpr float ColourConvert::GAMMA_TOLERANCE;
+
+const struct gamut ColourConvert::GAMUT_A = {{0.704f, 0.296f}, {0.2151f, 0.7106f}, {0.138f, 0.08f}};
+const struct gamut ColourConvert::GAMUT_B = {{0.675f, 0.322f}, {0.409f, 0.518f}, {0.167f, 0.04f}};
+const struct gamut ColourConvert::GAMUT_C = {{0.6915f, 0.3083f}, {0.17f, 0.7f}, {0.1532f, 0.0475f}};
+const struct gamut ColourConvert::GAMUT_DEFAULT = {{1.0f, 0.0f}, {0.0f, 1.0f}, {0.0f, 0.0f}};
+
+/**
+ *   @brief  sRGB to linear gamma step, read from the table for whole channel values
+ *
+ *   @param  c is a colour channel 0-255
+ *
+ *   @return float the linear channel 0-1
+ */
+float ColourConvert::gammaDecode(float c)
+{
+    int i = (int)c;
+    if (i >= 0 && i <= 255 && (float)i == c)
+        return gammaTables.decode[i];
+
+    c = c / 255.0f;
+    return (c > 0.04045f) ? pow((c + 0.055f) / (1.0f + 0.055f), 2.4f) : (c / 12.92f);
+}
+
+/**
+ *   @brief  Linear to sRGB gamma step, interpolated from the table between 0 and 1
+ *
+ *   @param  c is a linear colour channel
+ *
+ *   @return float the sRGB channel, 0-1 for channels in the gamut
+ */
+float ColourConvert::gammaEncode(float c)
+{
+    if (c <= 0.0031308f)
+        return 12.92f * c;
+    // out of gamut channels and the NaN of a zero y keep the exact formula
+    if (!(c < 1.0f))
+        return (1.0f + 0.055f) * pow(c, (1.0f / 2.4f)) - 0.055f;
+
+    float pos = c * GAMMA_ENCODE_STEPS;
+    int i = (int)pos;
+    float frac = pos - i;
+    return gammaTables.encode[i] + (gammaTables.encode[i + 1] - gammaTables.encode[i]) * frac;
+}
+
 /**
  *   @brief  RGB to XY converter
  *
@@ -30,19 +239,13 @@ using namespace std;
  *
  *   @return struct xy containing XY value representation of parameters
  */
-struct xy *ColourConvert::rgb2xy(float r, float g, float b)
+struct xy ColourConvert::rgb2xy(float r, float g, float b)
 {
     
-    //convert values 0-255 to between 0 and 1
-    float red = r/255.0f;
-    float green = g/255.0f;
-    float blue = b/255.0f;
-    
-    // gamma correction to rgb values
-    
-    red = (red > 0.04045f) ? pow((red + 0.055f) / (1.0f + 0.055f), 2.4f) : (red / 12.92f);
-    green = (green > 0.04045f) ? pow((green + 0.055f) / (1.0f + 0.055f), 2.4f) : (green / 12.92f);
-    blue = (blue > 0.04045f) ? pow((blue + 0.055f) / (1.0f + 0.055f), 2.4f) : (blue / 12.92f);
+    // convert values 0-255 to between 0 and 1 with gamma correction
+    float red = gammaDecode(r);
+    float green = gammaDecode(g);
+    float blue = gammaDecode(b);
     
     // convert the RGB values to xyz using wide rgb d65 conversion formula
     
@@ -52,12 +255,12 @@ struct xy *ColourConvert::rgb2xy(float r, float g, float b)
     
     // calculate the xy values from the xyz values
     float x = 0.0, y = 0.0;
-    if(X != 0.0 || Y != 0.0 || X != 0.0) {
+    if(X != 0.0 || Y != 0.0 || Z != 0.0) {
         x = X / (X + Y + Z);
         y = Y / (X + Y + Z);
     }
     
-    // TO DO : check for if the xy value lays in the color gamut triangle for the light
+    // the gamut of the light is applied by the overload taking a gamut
     // use the Y value of the XYZ as brightness
     
     // xy values cannot be less than zero
@@ -70,11 +273,11 @@ struct xy *ColourConvert::rgb2xy(float r, float g, float b)
     if (Y > 1.0)
         Y = 1.0;
     
-    struct xy *xyStruct = (struct xy*) malloc(sizeof(struct xy));
+    struct xy xyStruct;
     
-    xyStruct->brightness = Y * 254.0;
-    xyStruct->x = x;
-    xyStruct->y = y;
+    xyStruct.brightness = Y * 254.0;
+    xyStruct.x = x;
+    xyStruct.y = y;
     
     return xyStruct;
 }
@@ -88,7 +291,7 @@ struct xy *ColourConvert::rgb2xy(float r, float g, float b)
  *
  *   @return struct rgb containing RGB value representation of parameters
  */
-struct rgb *ColourConvert::xy2rgb(float inputX, float inputY, float brightness)
+struct rgb ColourConvert::xy2rgb(float inputX, float inputY, float brightness)
 {
     
     // CONVERT TO XYZ
@@ -108,9 +311,9 @@ struct rgb *ColourConvert::xy2rgb(float inputX, float inputY, float brightness)
     float b = X * 0.0556f - Y * 0.2040f + Z * 1.0570f;
     
     //apply reverse gamma correction
-    r = r <= 0.0031308f ? 12.92f * r : (1.0f + 0.055f) * pow(r, (1.0f / 2.4f)) - 0.055f;
-    g = g <= 0.0031308f ? 12.92f * g : (1.0f + 0.055f) * pow(g, (1.0f / 2.4f)) - 0.055f;
-    b = b <= 0.0031308f ? 12.92f * b : (1.0f + 0.055f) * pow(b, (1.0f / 2.4f)) - 0.055f;
+    r = gammaEncode(r);
+    g = gammaEncode(g);
+    b = gammaEncode(b);
     
     //convert to 0-255
     if (r > 0)
@@ -136,11 +339,11 @@ struct rgb *ColourConvert::xy2rgb(float inputX, float inputY, float brightness)
         b = 255;
     
     
-    // create pointer of rgb structure
-    struct rgb *rgbStruct = (struct rgb*) malloc(sizeof(struct rgb));
-    rgbStruct->r = r;
-    rgbStruct->b = b;
-    rgbStruct->g = g;
+    struct rgb rgbStruct;
+    rgbStruct.r = r;
+    rgbStruct.b = b;
+    rgbStruct.g = g;
+    rgbStruct.brightness = brightness;
     
     return rgbStruct;
 }
@@ -154,7 +357,7 @@ struct rgb *ColourConvert::xy2rgb(float inputX, float inputY, float brightness)
  *
  *   @return struct rgb containing RGB value representation of parameters
  */
-struct rgb *ColourConvert::hsv2rgb(float hue, float sat, float bri) {
+struct rgb ColourConvert::hsv2rgb(float hue, float sat, float bri) {
     float r, g, b;
     double hh, p, q, t, ff;
     long i;
@@ -162,15 +365,16 @@ struct rgb *ColourConvert::hsv2rgb(float hue, float sat, float bri) {
     double h = hue/ 65280.0; // hue in smartlights is 0-65280
     h = h * 360.0; // this formula uses an angle for hue
     
-    struct rgb *rgbStruct = (struct rgb*) malloc(sizeof(struct rgb));
+    struct rgb rgbStruct;
+    rgbStruct.brightness = bri;
     
     bri = bri / 254.0; // expected brightness value 0-1
     sat = sat / 255.0; // expected saturation value 0-1
     
     if (sat <= 0.0) {
-        rgbStruct->r = bri * 254.0;
-        rgbStruct->b = bri * 254.0;
-        rgbStruct->g = bri * 254.0;
+        rgbStruct.r = bri * 254.0;
+        rgbStruct.b = bri * 254.0;
+        rgbStruct.g = bri * 254.0;
         
         return rgbStruct;
         
@@ -223,9 +427,317 @@ struct rgb *ColourConvert::hsv2rgb(float hue, float sat, float bri) {
             break;
     }
     
-    rgbStruct->r = r * 255.0;
-    rgbStruct->g = g * 255.0;
-    rgbStruct->b = b * 255.0;
+    rgbStruct.r = r * 255.0;
+    rgbStruct.g = g * 255.0;
+    rgbStruct.b = b * 255.0;
     return rgbStruct;
     
 }
+
+/**
+ *   @brief  Batch RGB to XY converter
+ *
+ *   @param  *in is the array of colours to convert
+ *   @param  *out is the array the XY values are written to, may not overlap in
+ *   @param  count is the number of colours in both arrays
+ *
+ *   @return void
+ */
+void ColourConvert::rgb2xyBatch(const struct rgb *in, struct xy *out, size_t count)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 top = _mm_set1_ps(255.0f);
+    for (; i + 4 <= count; i += 4) {
+        // four colours of r, g, b, brightness turned into four reds, greens, blues and brightnesses
+        __m128 red = _mm_loadu_ps(&in[i].r);
+        __m128 green = _mm_loadu_ps(&in[i + 1].r);
+        __m128 blue = _mm_loadu_ps(&in[i + 2].r);
+        __m128 unused = _mm_loadu_ps(&in[i + 3].r);
+        _MM_TRANSPOSE4_PS(red, green, blue, unused);
+
+        // channels above 255 keep the exact formula
+        __m128 over = _mm_or_ps(_mm_or_ps(_mm_cmpgt_ps(red, top), _mm_cmpgt_ps(green, top)), _mm_cmpgt_ps(blue, top));
+        if (_mm_movemask_ps(over)) {
+            for (int j = 0; j < 4; j++) {
+                out[i + j] = rgb2xy(in[i + j].r, in[i + j].g, in[i + j].b);
+            }
+            continue;
+        }
+        red = gammaDecode4(red);
+        green = gammaDecode4(green);
+        blue = gammaDecode4(blue);
+
+        // same wide rgb d65 matrix as the single colour converter
+        __m128 X = _mm_add_ps(_mm_add_ps(_mm_mul_ps(red, _mm_set1_ps(0.649926f)), _mm_mul_ps(green, _mm_set1_ps(0.103455f))),
+                              _mm_mul_ps(blue, _mm_set1_ps(0.197109f)));
+        __m128 Y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(red, _mm_set1_ps(0.234327f)), _mm_mul_ps(green, _mm_set1_ps(0.743075f))),
+                              _mm_mul_ps(blue, _mm_set1_ps(0.022598f)));
+        __m128 Z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(red, _mm_set1_ps(0.000000f)), _mm_mul_ps(green, _mm_set1_ps(0.053077f))),
+                              _mm_mul_ps(blue, _mm_set1_ps(1.035763f)));
+
+        // black stays at 0, 0
+        __m128 sum = _mm_add_ps(_mm_add_ps(X, Y), Z);
+        __m128 lit = _mm_or_ps(_mm_or_ps(_mm_cmpneq_ps(X, zero), _mm_cmpneq_ps(Y, zero)), _mm_cmpneq_ps(Z, zero));
+        __m128 x = _mm_and_ps(lit, _mm_div_ps(X, sum));
+        __m128 y = _mm_and_ps(lit, _mm_div_ps(Y, sum));
+
+        // xy values cannot be less than zero
+        __m128 floor = _mm_set1_ps(0.00001f);
+        __m128 negative = _mm_cmplt_ps(x, zero);
+        x = _mm_or_ps(_mm_and_ps(negative, floor), _mm_andnot_ps(negative, x));
+        negative = _mm_cmplt_ps(y, zero);
+        y = _mm_or_ps(_mm_and_ps(negative, floor), _mm_andnot_ps(negative, y));
+        __m128 brightness = _mm_mul_ps(_mm_min_ps(_mm_max_ps(Y, zero), one), _mm_set1_ps(254.0f));
+
+        float xs[4], ys[4], bs[4];
+        _mm_storeu_ps(xs, x);
+        _mm_storeu_ps(ys, y);
+        _mm_storeu_ps(bs, brightness);
+        for (int j = 0; j < 4; j++) {
+            out[i + j].x = xs[j];
+            out[i + j].y = ys[j];
+            out[i + j].brightness = bs[j];
+        }
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = rgb2xy(in[i].r, in[i].g, in[i].b);
+    }
+}
+
+/**
+ *   @brief  Batch XY to RGB converter
+ *
+ *   @param  *in is the array of colours to convert, brightness is the brightness value of each light
+ *   @param  *out is the array the RGB values are written to, may not overlap in
+ *   @param  count is the number of colours in both arrays
+ *
+ *   @return void
+ */
+void ColourConvert::xy2rgbBatch(const struct xy *in, struct rgb *out, size_t count)
+{
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_setr_ps(in[i].x, in[i + 1].x, in[i + 2].x, in[i + 3].x);
+        __m128 y = _mm_setr_ps(in[i].y, in[i + 1].y, in[i + 2].y, in[i + 3].y);
+        __m128 brightness = _mm_setr_ps(in[i].brightness, in[i + 1].brightness,
+                                        in[i + 2].brightness, in[i + 3].brightness);
+
+        // same xyY to XYZ and wide rgb d65 matrix as the single colour converter
+        __m128 z = _mm_sub_ps(_mm_sub_ps(_mm_set1_ps(1.0f), x), y);
+        __m128 Y = _mm_div_ps(brightness, _mm_set1_ps(254.0f));
+        __m128 X = _mm_mul_ps(_mm_div_ps(Y, y), x);
+        __m128 Z = _mm_mul_ps(_mm_div_ps(Y, y), z);
+
+        __m128 r = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(X, _mm_set1_ps(3.2410f)), _mm_mul_ps(Y, _mm_set1_ps(1.5374f))),
+                              _mm_mul_ps(Z, _mm_set1_ps(0.4986f)));
+        __m128 g = _mm_add_ps(_mm_add_ps(_mm_mul_ps(X, _mm_set1_ps(-0.9692f)), _mm_mul_ps(Y, _mm_set1_ps(1.8760f))),
+                              _mm_mul_ps(Z, _mm_set1_ps(0.0416f)));
+        __m128 b = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(X, _mm_set1_ps(0.0556f)), _mm_mul_ps(Y, _mm_set1_ps(0.2040f))),
+                              _mm_mul_ps(Z, _mm_set1_ps(1.0570f)));
+
+        // reverse gamma correction, then convert to 0-255
+        const __m128 top = _mm_set1_ps(255.0f);
+        const __m128 zero = _mm_setzero_ps();
+        r = _mm_min_ps(_mm_max_ps(_mm_mul_ps(gammaEncode4(r), top), zero), top);
+        g = _mm_min_ps(_mm_max_ps(_mm_mul_ps(gammaEncode4(g), top), zero), top);
+        b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(gammaEncode4(b), top), zero), top);
+
+        // four reds, greens, blues and brightnesses written back as four colours
+        _MM_TRANSPOSE4_PS(r, g, b, brightness);
+        _mm_storeu_ps(&out[i].r, r);
+        _mm_storeu_ps(&out[i + 1].r, g);
+        _mm_storeu_ps(&out[i + 2].r, b);
+        _mm_storeu_ps(&out[i + 3].r, brightness);
+    }
+#endif
+    for (; i < count; i++) {
+        out[i] = xy2rgb(in[i].x, in[i].y, in[i].brightness);
+    }
+}
+
+/**
+ *   @brief  Batch Hue Sat Bri to RGB converter
+ *
+ *   @param  *in is the array of colours to convert
+ *   @param  *out is the array the RGB values are written to
+ *   @param  count is the number of colours in both arrays
+ *
+ *   @return void
+ */
+void ColourConvert::hsv2rgbBatch(const struct hsv *in, struct rgb *out, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        out[i] = hsv2rgb(in[i].hue, in[i].sat, in[i].bri);
+    }
+}
+
+/**
+ *   @brief  Gamut of a light model. The table is built on first use and read only afterwards,
+ *           so every lookup is one hash of the model id.
+ *
+ *   @param  &modelid is the model id the light reports
+ *
+ *   @return gamut of the model, GAMUT_DEFAULT for models not in the table
+ */
+const struct gamut &ColourConvert::gamutFor(const string &modelid)
+{
+    static const unordered_map<string, const struct gamut *> gamuts = {
+        {"LLC001", &GAMUT_A}, {"LLC005", &GAMUT_A}, {"LLC006", &GAMUT_A}, {"LLC007", &GAMUT_A},
+        {"LLC010", &GAMUT_A}, {"LLC011", &GAMUT_A}, {"LLC012", &GAMUT_A}, {"LLC013", &GAMUT_A},
+        {"LLC014", &GAMUT_A}, {"LST001", &GAMUT_A},
+        {"LCT001", &GAMUT_B}, {"LCT002", &GAMUT_B}, {"LCT003", &GAMUT_B}, {"LCT007", &GAMUT_B},
+        {"LLM001", &GAMUT_B},
+        {"LCT010", &GAMUT_C}, {"LCT011", &GAMUT_C}, {"LCT012", &GAMUT_C}, {"LCT014", &GAMUT_C},
+        {"LCT015", &GAMUT_C}, {"LCT016", &GAMUT_C}, {"LLC020", &GAMUT_C}, {"LST002", &GAMUT_C}
+    };
+
+    unordered_map<string, const struct gamut *>::const_iterator it = gamuts.find(modelid);
+    return it == gamuts.end() ? GAMUT_DEFAULT : *it->second;
+}
+
+/**
+ *   @brief  Closest point to p on the segment from a to b
+ *
+ *   @param  p is the point
+ *   @param  a is the start of the segment
+ *   @param  b is the end of the segment
+ *   @param  &out is set to the closest point
+ *
+ *   @return float squared distance from p to the closest point
+ */
+static float closestOnSegment(const float p[2], const float a[2], const float b[2], float out[2])
+{
+    float abx = b[0] - a[0], aby = b[1] - a[1];
+    float t = ((p[0] - a[0]) * abx + (p[1] - a[1]) * aby) / (abx * abx + aby * aby);
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    out[0] = a[0] + abx * t;
+    out[1] = a[1] + aby * t;
+    float dx = p[0] - out[0], dy = p[1] - out[1];
+    return dx * dx + dy * dy;
+}
+
+/**
+ *   @brief  Move an xy colour to the closest colour inside a gamut triangle, the same way the
+ *           bridge does before it sets the light
+ *
+ *   @param  colour is the xy colour, its brightness is kept
+ *   @param  &lightGamut is the gamut of the light
+ *
+ *   @return struct xy of the colour inside the gamut
+ */
+struct xy ColourConvert::clampToGamut(struct xy colour, const struct gamut &lightGamut)
+{
+    const float p[2] = {colour.x, colour.y};
+    const float *r = lightGamut.red, *g = lightGamut.green, *b = lightGamut.blue;
+
+    // inside when p is on the same side of all three edges
+    float d1 = (g[0] - r[0]) * (p[1] - r[1]) - (g[1] - r[1]) * (p[0] - r[0]);
+    float d2 = (b[0] - g[0]) * (p[1] - g[1]) - (b[1] - g[1]) * (p[0] - g[0]);
+    float d3 = (r[0] - b[0]) * (p[1] - b[1]) - (r[1] - b[1]) * (p[0] - b[0]);
+    bool negative = d1 < 0 || d2 < 0 || d3 < 0;
+    bool positive = d1 > 0 || d2 > 0 || d3 > 0;
+    if (!(negative && positive))
+        return colour;
+
+    float best[2], candidate[2];
+    float bestDistance = closestOnSegment(p, r, g, best);
+    float distance = closestOnSegment(p, g, b, candidate);
+    if (distance < bestDistance) {
+        bestDistance = distance;
+        best[0] = candidate[0];
+        best[1] = candidate[1];
+    }
+    distance = closestOnSegment(p, b, r, candidate);
+    if (distance < bestDistance) {
+        best[0] = candidate[0];
+        best[1] = candidate[1];
+    }
+
+    colour.x = best[0];
+    colour.y = best[1];
+    return colour;
+}
+
+/**
+ *   @brief  RGB to XY converter for a light, the result is inside the gamut of the light
+ *
+ *   @param  r is the red component of the colour
+ *   @param  g is the green component of the colour
+ *   @param  b is the blue component of the colour
+ *   @param  &lightGamut is the gamut of the light
+ *
+ *   @return struct xy containing XY value representation of parameters
+ */
+struct xy ColourConvert::rgb2xy(float r, float g, float b, const struct gamut &lightGamut)
+{
+    return clampToGamut(rgb2xy(r, g, b), lightGamut);
+}
+
+/**
+ *   @brief  Colour temperature to RGB converter, interpolated from the table
+ *
+ *   @param  ct is the colour temperature in mired, 153-500
+ *   @param  bri is the brightness value of the light
+ *
+ *   @return struct rgb containing RGB value representation of parameters
+ */
+struct rgb ColourConvert::ct2rgb(float ct, float bri)
+{
+    float frac;
+    int i = ctIndex(ct, frac);
+    const struct rgb &lo = ctTables.rgb[i], &hi = ctTables.rgb[i + 1];
+    float scale = bri / 254.0f;
+
+    struct rgb rgbStruct;
+    rgbStruct.r = (lo.r + (hi.r - lo.r) * frac) * scale;
+    rgbStruct.g = (lo.g + (hi.g - lo.g) * frac) * scale;
+    rgbStruct.b = (lo.b + (hi.b - lo.b) * frac) * scale;
+    rgbStruct.brightness = bri;
+    return rgbStruct;
+}
+
+/**
+ *   @brief  Colour temperature to XY converter, interpolated from the table
+ *
+ *   @param  ct is the colour temperature in mired, 153-500
+ *   @param  bri is the brightness value of the light
+ *
+ *   @return struct xy containing XY value representation of parameters
+ */
+struct xy ColourConvert::ct2xy(float ct, float bri)
+{
+    float frac;
+    int i = ctIndex(ct, frac);
+    const struct xy &lo = ctTables.xy[i], &hi = ctTables.xy[i + 1];
+
+    struct xy xyStruct;
+    xyStruct.x = lo.x + (hi.x - lo.x) * frac;
+    xyStruct.y = lo.y + (hi.y - lo.y) * frac;
+    xyStruct.brightness = bri;
+    return xyStruct;
+}
+
+/**
+ *   @brief  XY to colour temperature converter, using McCamy's approximation
+ *
+ *   @param  x is the X component of the colour
+ *   @param  y is the Y component of the colour
+ *
+ *   @return float colour temperature in mired, clamped to 153-500
+ */
+float ColourConvert::xy2ct(float x, float y)
+{
+    float n = (x - 0.3320f) / (0.1858f - y);
+    float kelvin = 449.0f * n * n * n + 3525.0f * n * n + 6823.3f * n + 5520.33f;
+    float ct = kelvin > 0 ? 1000000.0f / kelvin : CT_MAX;
+
+    if (!(ct > CT_MIN)) ct = CT_MIN;
+    if (ct > CT_MAX) ct = CT_MAX;
+    return ct;
+}
@@ -21,8 +21,12 @@
 #include <iostream>
 #include <unistd.h>
 #include "CreateAccountWidget.h"
-#include "Hash.h" // for password encryption
+#include "HashPool.h" // for password encryption
 #include "Account.h"
+#include "AccountStore.h"
+#include "LoginThrottle.h"
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
 
 using namespace Wt;
 using namespace std;
@@ -31,15 +35,13 @@ using namespace std;
  *   @brief  Create Account Widget constructor
  *
  *   @param  *parent is a pointer the the containerwidget that stores this widget
- *   @param  *account is a pointer to the user account object
  *   @param  *main is a pointer to the app's welcome screen
  */
-CreateAccountWidget::CreateAccountWidget(WContainerWidget *parent, Account *account, WelcomeScreen *main):
+CreateAccountWidget::CreateAccountWidget(WContainerWidget *parent, WelcomeScreen *main):
 WContainerWidget(parent)
 {
     setContentAlignment(AlignCenter);
     parent_ = main;
-    account_ = account;
     setStyleClass("w3-animate-opacity");
 }
 
@@ -161,17 +163,50 @@ void CreateAccountWidget::submit(){
         unsuccessfulPassword_->setHidden(false); // show user that passwords don't match
     }
     else if (!CreateAccountWidget::validateInputFields()) {
+        unsuccessfulInput_->setText("Please fill all boxes with valid input.");
+        unsuccessfulInput_->setHidden(false);
+    }
+    // checking names is throttled like logins, so accounts cannot be enumerated quickly
+    else if (!LoginThrottle::instance()->allow(WApplication::instance()->environment().clientAddress(), "")) {
+        unsuccessfulInput_->setText("Too many attempts, please wait and try again.");
         unsuccessfulInput_->setHidden(false);
     }
     else if (!CreateAccountWidget::checkNewUserid(username_->text().toUTF8())){
 
         accountExists_->setHidden(false);
     }
-    else { // if password and confirmed password match
-        CreateAccountWidget::writeUserInfo(username_->text().toUTF8(), password_->text().toUTF8(), firstName_->text().toUTF8(), lastName_->text().toUTF8()); // write the user's credentials to file
-        WApplication::instance()->setInternalPath("/login", true);
+    // if password and confirmed password match, hash the password on the hashing workers, passwordHashed stores the account
+    else if (!HashPool::instance()->hash(password_->text().toUTF8(), WApplication::instance()->sessionId(),
+                                         boost::bind(&CreateAccountWidget::passwordHashed, this, username_->text().toUTF8(),
+                                                     firstName_->text().toUTF8(), lastName_->text().toUTF8(), _1))) {
+        unsuccessfulInput_->setText("The server is busy, please try again.");
+        unsuccessfulInput_->setHidden(false);
     }
+    else {
+        createAccountButton_->setDisabled(true);
+    }
+
+}
 
+/**
+ *   @brief  passwordHashed() function, called in this session with the hash of the new password.
+ *           Writes the account and redirects to the login screen.
+ *   @param  username is a string representing the user's inputted username
+ *   @param  firstName is the user's first name
+ *   @param  lastName is the user's last name
+ *   @param  hashed is the hash of the password, empty if it could not be made
+ */
+void CreateAccountWidget::passwordHashed(string username, string firstName, string lastName, string hashed) {
+    createAccountButton_->setDisabled(false);
+
+    // the name can still be taken by another user in the meantime
+    if (hashed == "" || !CreateAccountWidget::writeUserInfo(username, hashed, firstName, lastName)) {
+        accountExists_->setHidden(false);
+    }
+    else {
+        WApplication::instance()->setInternalPath("/login", true);
+    }
+    WApplication::instance()->triggerUpdate();
 }
 
 /**
@@ -181,59 +216,22 @@ void CreateAccountWidget::submit(){
  *   @return  bool: true if the username is "new" false if already exists
  */
 bool CreateAccountWidget::checkNewUserid(string userid) {
-    string file = "credentials/" + userid + ".txt";
-    ifstream f(file.c_str());
-    return !f.good();
+    return !AccountStore::instance()->exists(userid);
 }
 
 /**
- *   @brief  writeCredentials() function, writes an encrypted version of the user's password
- *           into username.txt
+ *   @brief  writeCredentials() function, stores the new account with an encrypted version of the
+ *           user's password in the account store
  *   @param  username is a string representing the user's inputted username
- *   @param  password is a string representing the user's inputted password
+ *   @param  hashedPassword is the cryptographic hash of the user's inputted password
+ *   @return  bool: false if the account could not be created
  */
-void CreateAccountWidget::writeUserInfo(string username, string password, string firstName, string lastName) {
-
-    // creates credentials folder if one does not exist
-    const int dir_err = system("mkdir -p credentials");
-    if (-1 == dir_err)
-    {
-        cout << "ERROR - Could not create directory\n";
-        exit(1);
-    }
-
-    ofstream writefile;
-    string file = "credentials/" + username + ".txt";
-
-    writefile.open(file.c_str());
-
-    writefile << Hash::sha256_hash(password) <<endl; // cryptographically hash password
-
-    writefile<< firstName << endl;
-    writefile<< lastName << endl;
+bool CreateAccountWidget::writeUserInfo(string username, string hashedPassword, string firstName, string lastName) {
 
-    writefile.close();
-    //TODO: Error handling in the file write
-
-    // creates profile pictures folder if one does not exist
-    const int prof_pic_dir_err = system("mkdir -p Wt/images/ppics");
-    if (-1 == prof_pic_dir_err)
-    {
-        cout << "ERROR - Could not create directory\n";
-        exit(1);
+    if (!AccountStore::instance()->create(username, hashedPassword, firstName, lastName)) {
+        return false;
     }
-
-
-    string profPicFile = "Wt/images/ppics/" + username; // file extension?
-    string defaultProfPicFileLocation = "Wt/images/default_ppic.png";
-
-
-    ifstream ppic_in(defaultProfPicFileLocation.c_str());//ios::binary);
-    ofstream ppic_writefile(profPicFile.c_str());
-    ppic_writefile << ppic_in.rdbuf();
-    ppic_writefile.close();
-    ppic_in.close();
-
+    return true;
 }
 
 /**
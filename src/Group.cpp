@@ -12,6 +12,7 @@
  */
 
 #include "Group.h"
+#include <stdlib.h>
 
 /**
  *   @brief  Group constructor
@@ -20,58 +21,41 @@
  *   @param  groupData the Json object of a Group from the Hue API
  *
  */
-Group::Group(WString groupNum, Json::Object groupData) {
-    groupnum_ = groupNum;
-    if(groupData.type("name") != 0) name_ = groupData.get("name");
-    else name_ = "null";
+Group::Group(WString groupNum, const Json::Object &groupData) :
+flags_(0)
+{
+    setGroupnum(groupNum);
+    name_ = groupData.get("name").orIfNull("null").toUTF8();
     
     if(groupData.type("action") != 0) {
-        Json::Object action = groupData.get("action");
-        if(action.type("alert") != 0) alert_ = action.get("alert");
-        else alert_ = "null";
-        
-        if(action.type("bri") != 0) bri_ = action.get("bri");
-        else bri_ = -1;
-        
-        if(action.type("colormode") != 0) colormode_ = action.get("colormode");
-        else colormode_ = "null";
-        
-        if(action.type("ct") != 0) ct_ = action.get("ct");
-        else ct_ = -1;
-        
-        if(action.type("effect") != 0) effect_ = action.get("effect");
-        else effect_ = "null";
-        
-        if(action.type("hue") != 0) hue_ = action.get("hue");
-        else hue_ = -1;
-        
-        if(action.type("on") != 0) on_ = action.get("on");
-        else on_ = 0;
-        
-        if(action.type("reachable") != 0) reachable_ = action.get("reachable");
-        else reachable_ = 0;
-        
-        if(action.type("sat") != 0) sat_ = action.get("sat");
-        else sat_ = -1;
+        const Json::Object &action = groupData.get("action");
+        alert_ = HueTypes::parseAlert(action.get("alert").orIfNull("null").toUTF8());
+        colormode_ = HueTypes::parseColorMode(action.get("colormode").orIfNull("null").toUTF8());
+        effect_ = HueTypes::parseEffect(action.get("effect").orIfNull("null").toUTF8());
+        setBri(action.get("bri").orIfNull(-1));
+        setCt(action.get("ct").orIfNull(-1));
+        setHue(action.get("hue").orIfNull(-1));
+        setSat(action.get("sat").orIfNull(-1));
+        setOn(action.get("on").orIfNull(false));
+        setReachable(action.get("reachable").orIfNull(false));
         
         if(action.type("xy") != 0) {
-            Json::Array xy = action.get("xy");
-            xy_[0] = xy[0];
-            xy_[1] = xy[1];
-        }
-        else {
-            xy_[0] = -1.0;
-            xy_[1] = -1.0;
+            const Json::Array &xy = action.get("xy");
+            setX(xy[0]);
+            setY(xy[1]);
         }
     }
+    else {
+        alert_ = AlertNull;
+        colormode_ = ColorModeNull;
+        effect_ = EffectNull;
+    }
     
     if(groupData.type("lights") != 0) {
-        Json::Array lights = groupData.get("lights");
-        lights_.reserve(5);
-        if(groupData.type("lights") != 0) {
-            for(Json::Value lightNum : lights) {
-                addLight(lightNum);
-            }
+        const Json::Array &lights = groupData.get("lights");
+        lights_.reserve(lights.size());
+        for(const Json::Value &lightNum : lights) {
+            addLight(atoi(lightNum.orIfNull("").toUTF8().c_str()));
         }
     }
     
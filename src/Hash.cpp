@@ -13,16 +13,32 @@
  *              Two of the same passwords run through the same function would return the same hash,
  *              however, it is near impossible to reverse-engineer this function to take the hash
  *              and return the plain-text password
+ *
+ *              Passwords are stored as PBKDF2-HMAC-SHA256 with a random salt, written as
+ *              "pbkdf2_sha256$<iterations>$<salt>$<key>" in hex. The iteration count is the cost
+ *              and can be tuned with setIterations. Plain SHA256 hashes of older accounts are
+ *              still verified, needsRehash reports them so they are upgraded at login.
  */
 
 #include "Hash.h"
-#include <iomanip>
+#include <atomic>
+#include <cstdlib>
 #include <iostream>
-#include <sstream>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/sha.h>
 
 using namespace std;
 
+namespace {
+
+const string PBKDF2_PREFIX = "pbkdf2_sha256$";
+
+atomic<int> iterations(Hash::DEFAULT_ITERATIONS); // rounds of new hashes
+
+}
+
 /**
 *   @brief  sha256_hash function, a static function which takes a plaintext string and outputs an encrypted string
 *
@@ -41,13 +57,163 @@ string Hash::sha256_hash(const string str)
     SHA256_Update(&sha256, str.c_str(), str.size());
     SHA256_Final(hash, &sha256);
 
-    stringstream ss;
+    return toHex(hash, SHA256_DIGEST_LENGTH);
+}
+
+/**
+*   @brief  hashPassword function, derives a key from the password with PBKDF2 and a new random salt
+*
+*   @param  &password is the plain-text password
+*   @return string "pbkdf2_sha256$<iterations>$<salt>$<key>", empty if no salt could be generated
+*
+*/
+string Hash::hashPassword(const string &password)
+{
+    unsigned char salt[SALT_LENGTH];
+    if (RAND_bytes(salt, SALT_LENGTH) != 1) {
+        cerr << "HASH: Unable to generate a salt\n";
+        return "";
+    }
+
+    int rounds = iterations;
+    string key = pbkdf2(password, string((const char *)salt, SALT_LENGTH), rounds);
+    return PBKDF2_PREFIX + to_string(rounds) + "$" + toHex(salt, SALT_LENGTH) + "$"
+           + toHex((const unsigned char *)key.data(), key.size());
+}
+
+/**
+*   @brief  verifyPassword function, checks a password against a stored PBKDF2 or plain SHA256 hash
+*
+*   @param  &password is the plain-text password
+*   @param  &stored is the hash stored for the account
+*   @return bool true if the password matches
+*
+*/
+bool Hash::verifyPassword(const string &password, const string &stored)
+{
+    string expected;
+    string actual;
+
+    if (stored.compare(0, PBKDF2_PREFIX.size(), PBKDF2_PREFIX) != 0) {
+        //hash of an account created before PBKDF2
+        expected = stored;
+        actual = sha256_hash(password);
+    }
+    else {
+        size_t saltStart = stored.find('$', PBKDF2_PREFIX.size());
+        size_t keyStart = saltStart == string::npos ? string::npos : stored.find('$', saltStart + 1);
+        if (keyStart == string::npos) return false;
+
+        int rounds = atoi(stored.substr(PBKDF2_PREFIX.size(), saltStart - PBKDF2_PREFIX.size()).c_str());
+        string salt;
+        if (rounds <= 0 || !fromHex(stored.substr(saltStart + 1, keyStart - saltStart - 1), salt)
+            || !fromHex(stored.substr(keyStart + 1), expected)) {
+            return false;
+        }
+        actual = pbkdf2(password, salt, rounds);
+    }
+
+    //constant time, so the comparison does not reveal how much of the hash matched
+    return expected.size() == actual.size() && CRYPTO_memcmp(expected.data(), actual.data(), actual.size()) == 0;
+}
+
+/**
+*   @brief  needsRehash function, checks if a stored hash is weaker than new hashes
+*
+*   @param  &stored is the hash stored for the account
+*   @return bool true if the hash is plain SHA256 or uses fewer iterations than the current setting
+*
+*/
+bool Hash::needsRehash(const string &stored)
+{
+    if (stored.compare(0, PBKDF2_PREFIX.size(), PBKDF2_PREFIX) != 0) return true;
+    return atoi(stored.c_str() + PBKDF2_PREFIX.size()) < iterations;
+}
+
+/**
+*   @brief  setIterations function, sets the PBKDF2 rounds of new hashes, the cost of hashing a password
+*
+*   @param  rounds is the number of rounds, at least MIN_ITERATIONS
+*
+*/
+void Hash::setIterations(int rounds)
+{
+    iterations = rounds < MIN_ITERATIONS ? MIN_ITERATIONS : rounds;
+}
+
+/**
+*   @brief  getIterations function, PBKDF2 rounds of new hashes
+*
+*   @return int the number of rounds
+*
+*/
+int Hash::getIterations()
+{
+    return iterations;
+}
 
-    for (int i = 0; i < SHA256_DIGEST_LENGTH; i++)
+/**
+*   @brief  toHex function, formats bytes as lower case hex
+*
+*   @param  *bytes is the bytes
+*   @param  length is the number of bytes
+*   @return string of two hex digits per byte
+*
+*/
+string Hash::toHex(const unsigned char *bytes, int length)
+{
+    static const char digits[] = "0123456789abcdef";
+    string hex(length * 2, '0');
+    for (int i = 0; i < length; i++)
     {
-        ss << hex << setw(2) << setfill('0') << (int)hash[i];
+        hex[i * 2] = digits[bytes[i] >> 4];
+        hex[i * 2 + 1] = digits[bytes[i] & 0x0f];
+    }
+    return hex;
+}
+
+/**
+*   @brief  fromHex function, parses hex into bytes
+*
+*   @param  &hex is the hex string
+*   @param  &bytes is filled with the parsed bytes
+*   @return bool false if the string is not hex
+*
+*/
+bool Hash::fromHex(const string &hex, string &bytes)
+{
+    if (hex.size() % 2 != 0) return false;
 
+    bytes.resize(hex.size() / 2);
+    for (size_t i = 0; i < hex.size(); i++)
+    {
+        char c = hex[i];
+        int value;
+        if (c >= '0' && c <= '9') value = c - '0';
+        else if (c >= 'a' && c <= 'f') value = c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') value = c - 'A' + 10;
+        else return false;
+
+        if (i % 2 == 0) bytes[i / 2] = (char)(value << 4);
+        else bytes[i / 2] = (char)(bytes[i / 2] | value);
     }
+    return true;
+}
 
-    return ss.str();
+/**
+*   @brief  pbkdf2 function, derives a key with PBKDF2-HMAC-SHA256
+*
+*   @param  &password is the plain-text password
+*   @param  &salt is the raw salt
+*   @param  rounds is the number of rounds
+*   @return string of KEY_LENGTH raw bytes
+*
+*/
+string Hash::pbkdf2(const string &password, const string &salt, int rounds)
+{
+    unsigned char key[KEY_LENGTH];
+    PKCS5_PBKDF2_HMAC(password.c_str(), password.size(),
+                      (const unsigned char *)salt.data(), salt.size(),
+                      rounds, EVP_sha256(), KEY_LENGTH, key);
+    return string((const char *)key, KEY_LENGTH);
 }
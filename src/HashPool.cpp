@@ -0,0 +1,156 @@
+/**
+ *  @file       HashPool.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application password hashing workers
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class hashes and verifies passwords on a few threads of its own, so the
+ *              deliberately slow PBKDF2 of a login never runs on the threads that serve the
+ *              sessions. The queue is bounded: when a burst of logins fills it, new requests
+ *              are refused and the session can ask the user to try again instead of every
+ *              session waiting behind the burst. Results are posted back to the session that
+ *              asked, like the bridge scheduler does.
+ */
+
+#include <Wt/WServer>
+#include <boost/bind.hpp>
+#include <iostream>
+#include "HashPool.h"
+#include "Hash.h"
+
+using namespace Wt;
+
+/**
+ *   @brief  Returns the pool shared by every session of the process
+ *
+ *   @return  HashPool* the pool
+ */
+HashPool *HashPool::instance() {
+    static HashPool pool;
+    return &pool;
+}
+
+/**
+ *   @brief  HashPool constructor, starts the workers
+ *
+ */
+HashPool::HashPool() :
+stopping_(false)
+{
+    for(int i = 0; i < THREADS; i++) {
+        workers_.push_back(thread(&HashPool::work, this));
+    }
+}
+
+/**
+ *   @brief  HashPool destructor, lets the workers finish the queued jobs and joins them
+ *
+ */
+HashPool::~HashPool() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    ready_.notify_all();
+    for(thread &worker : workers_) {
+        worker.join();
+    }
+}
+
+/**
+ *   @brief  Hash a new password on a worker
+ *
+ *   @param  &password is the plain-text password
+ *   @param  &sessionId is the session the result is posted to, empty outside of a session
+ *   @param  &done is called in the session with the hash, empty if it could not be made
+ *
+ *   @return  bool false if the queue is full and the password was not queued
+ */
+bool HashPool::hash(const string &password, const string &sessionId,
+                    const boost::function<void (string)> &done) {
+    return submit([password, sessionId, done]() {
+        string hashed = Hash::hashPassword(password);
+        deliver(sessionId, boost::bind(done, hashed));
+    });
+}
+
+/**
+ *   @brief  Verify a password on a worker. A correct password whose stored hash is weaker than
+ *           new hashes is hashed again, so the account can be upgraded.
+ *
+ *   @param  &password is the plain-text password
+ *   @param  &stored is the hash stored for the account
+ *   @param  &sessionId is the session the result is posted to, empty outside of a session
+ *   @param  &done is called in the session with whether the password matched and the upgraded
+ *                 hash, empty if the stored one is current
+ *
+ *   @return  bool false if the queue is full and the password was not queued
+ */
+bool HashPool::verify(const string &password, const string &stored, const string &sessionId,
+                      const boost::function<void (bool, string)> &done) {
+    return submit([password, stored, sessionId, done]() {
+        bool matched = Hash::verifyPassword(password, stored);
+        string upgraded = matched && Hash::needsRehash(stored) ? Hash::hashPassword(password) : "";
+        deliver(sessionId, boost::bind(done, matched, upgraded));
+    });
+}
+
+/**
+ *   @brief  Queue a job for the workers
+ *
+ *   @param  &job is the job
+ *
+ *   @return  bool false if QUEUE_LIMIT jobs are already waiting
+ */
+bool HashPool::submit(const boost::function<void ()> &job) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        if(stopping_ || (int)jobs_.size() >= QUEUE_LIMIT) {
+            cerr << "HASH: Queue full, refusing a password\n";
+            return false;
+        }
+        jobs_.push_back(job);
+    }
+    ready_.notify_one();
+    return true;
+}
+
+/**
+ *   @brief  Loop of a worker, runs queued jobs until the pool stops
+ *
+ *   @return  void
+ */
+void HashPool::work() {
+    while(true) {
+        boost::function<void ()> job;
+        {
+            unique_lock<mutex> lock(mutex_);
+            ready_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+            if(jobs_.empty()) return;
+            job = jobs_.front();
+            jobs_.pop_front();
+        }
+        job();
+    }
+}
+
+/**
+ *   @brief  Hand a result to the session that asked for it
+ *
+ *   @param  &sessionId is the session, empty outside of a session
+ *   @param  &result is the callback to run
+ *
+ *   @return  void
+ */
+void HashPool::deliver(const string &sessionId, const boost::function<void ()> &result) {
+    if(sessionId == "" || !WServer::instance()) {
+        result();
+    }
+    else {
+        WServer::instance()->post(sessionId, result);
+    }
+}
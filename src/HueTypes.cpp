@@ -0,0 +1,124 @@
+/**
+ *  @file       HueTypes.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application compact types for Light, Group and Schedule
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This is a helper class that converts the Hue API's colormode, alert and effect
+ *              strings to one byte enums and back, and interns strings that repeat across
+ *              lights, such as model ids and light types. Interned strings are kept for the
+ *              life of the process and shared by every session, so a light only stores a
+ *              pointer to them.
+ */
+
+#include "HueTypes.h"
+#include <mutex>
+#include <unordered_set>
+
+/**
+ *   @brief  Convert a Hue API colormode string
+ *
+ *   @param  colormode is the string, e.g. "xy"
+ *
+ *   @return  ColorMode the colour mode, ColorModeNull if it is not known
+ */
+ColorMode HueTypes::parseColorMode(const string &colormode) {
+    if(colormode == "hs") return ColorModeHS;
+    if(colormode == "xy") return ColorModeXY;
+    if(colormode == "ct") return ColorModeCT;
+    return ColorModeNull;
+}
+
+/**
+ *   @brief  Convert a Hue API alert string
+ *
+ *   @param  alert is the string, e.g. "select"
+ *
+ *   @return  AlertMode the alert mode, AlertNull if it is not known
+ */
+AlertMode HueTypes::parseAlert(const string &alert) {
+    if(alert == "none") return AlertNone;
+    if(alert == "select") return AlertSelect;
+    if(alert == "lselect") return AlertLSelect;
+    return AlertNull;
+}
+
+/**
+ *   @brief  Convert a Hue API effect string
+ *
+ *   @param  effect is the string, e.g. "colorloop"
+ *
+ *   @return  EffectMode the effect, EffectNull if it is not known
+ */
+EffectMode HueTypes::parseEffect(const string &effect) {
+    if(effect == "none") return EffectNone;
+    if(effect == "colorloop") return EffectColorloop;
+    return EffectNull;
+}
+
+/**
+ *   @brief  Returns the Hue API string of a colour mode
+ *
+ *   @param  colormode is the colour mode
+ *
+ *   @return  string the string, "null" for ColorModeNull
+ */
+string HueTypes::colorModeName(ColorMode colormode) {
+    switch(colormode) {
+        case ColorModeHS: return "hs";
+        case ColorModeXY: return "xy";
+        case ColorModeCT: return "ct";
+        default: return "null";
+    }
+}
+
+/**
+ *   @brief  Returns the Hue API string of an alert mode
+ *
+ *   @param  alert is the alert mode
+ *
+ *   @return  string the string, "null" for AlertNull
+ */
+string HueTypes::alertName(AlertMode alert) {
+    switch(alert) {
+        case AlertNone: return "none";
+        case AlertSelect: return "select";
+        case AlertLSelect: return "lselect";
+        default: return "null";
+    }
+}
+
+/**
+ *   @brief  Returns the Hue API string of an effect
+ *
+ *   @param  effect is the effect
+ *
+ *   @return  string the string, "null" for EffectNull
+ */
+string HueTypes::effectName(EffectMode effect) {
+    switch(effect) {
+        case EffectNone: return "none";
+        case EffectColorloop: return "colorloop";
+        default: return "null";
+    }
+}
+
+/**
+ *   @brief  Returns the shared copy of a string. Only strings from a small set, such as model
+ *           ids and light types, should be interned since they are never freed.
+ *
+ *   @param  value is the string
+ *
+ *   @return  const string* the shared copy, valid for the life of the process
+ */
+const string *HueTypes::intern(const string &value) {
+    static mutex poolMutex;
+    static unordered_set<string> pool;
+
+    lock_guard<mutex> lock(poolMutex);
+    return &*pool.insert(value).first;
+}
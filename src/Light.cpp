@@ -12,6 +12,7 @@
  */
 
 #include "Light.h"
+#include <stdlib.h>
 
 /**
  *   @brief  Light constructor
@@ -20,51 +21,35 @@
  *   @param  lightData the Json object of a Light from the Hue API
  *
  */
-Light::Light(WString lightNum, Json::Object lightData) {
-    lightnum_ = lightNum;
-    if(lightData.type("name") != 0) name_ = lightData.get("name");
-    else name_ = "null";
-    if(lightData.type("type") != 0) type_ = lightData.get("type");
-    else type_ = "null";
-    if(lightData.type("modelid") != 0) modelid_ = lightData.get("modelid");
-    else modelid_ = "null";
-    
-    Json::Object state = lightData.get("state");
-    if(state.type("alert") != 0) alert_ = state.get("alert");
-    else alert_ = "null";
-    
-    if(state.type("bri") != 0) bri_ = state.get("bri");
-    else bri_ = -1;
-    
-    if(state.type("colormode") != 0) colormode_ = state.get("colormode");
-    else colormode_ = "null";
-    
-    if(state.type("ct") != 0) ct_ = state.get("ct");
-    else ct_ = -1;
-    
-    if(state.type("effect") != 0) effect_ = state.get("effect");
-    else effect_ = "null";
-    
-    if(state.type("hue") != 0) hue_ = state.get("hue");
-    else hue_ = -1;
-    
-    if(state.type("on") != 0) on_ = state.get("on");
-    else on_ = 0;
-    
-    if(state.type("reachable") != 0) reachable_ = state.get("reachable");
-    else reachable_ = 0;
+Light::Light(WString lightNum, const Json::Object &lightData) :
+flags_(0)
+{
+    static_assert(sizeof(Light) <= LIGHT_BYTE_BUDGET, "Light is over its byte budget");
+
+    num_ = atoi(lightNum.toUTF8().c_str());
+    name_ = lightData.get("name").orIfNull("null").toUTF8();
+    type_ = HueTypes::intern(lightData.get("type").orIfNull("null").toUTF8());
+    modelid_ = HueTypes::intern(lightData.get("modelid").orIfNull("null").toUTF8());
     
-    if(state.type("sat") != 0) sat_ = state.get("sat");
-    else sat_ = -1;
+    const Json::Object &state = lightData.get("state");
+    alert_ = HueTypes::parseAlert(state.get("alert").orIfNull("null").toUTF8());
+    colormode_ = HueTypes::parseColorMode(state.get("colormode").orIfNull("null").toUTF8());
+    effect_ = HueTypes::parseEffect(state.get("effect").orIfNull("null").toUTF8());
+    setBri(state.get("bri").orIfNull(-1));
+    setCt(state.get("ct").orIfNull(-1));
+    setHue(state.get("hue").orIfNull(-1));
+    setSat(state.get("sat").orIfNull(-1));
+    setOn(state.get("on").orIfNull(false));
+    setReachable(state.get("reachable").orIfNull(false));
     
     if(state.type("xy") != 0) {
-        Json::Array xy = state.get("xy");
-        xy_[0] = xy[0];
-        xy_[1] = xy[1];
+        const Json::Array &xy = state.get("xy");
+        setX(xy[0]);
+        setY(xy[1]);
     }
     else {
-        xy_[0] = -1.0;
-        xy_[1] = -1.0;
+        setX(-1.0);
+        setY(-1.0);
     }
     
     transitiontime_ = 4; //default value from Hue is 0.4s (400ms)
@@ -24,6 +24,7 @@
 #include <Wt/WPopupMenuItem>
 #include <Wt/WColor>
 #include <Wt/WCssDecorationStyle>
+#include <Wt/WCssStyleSheet>
 #include <Wt/WMenu>
 #include <Wt/WStackedWidget>
 #include <Wt/WImage>
@@ -49,14 +50,43 @@ WContainerWidget(parent),
 overviewWidget_(0),
 lightsWidget_(0),
 groupsWidget_(0),
-schedulesWidget_(0)
+schedulesWidget_(0),
+lightsTable_(0),
+groupsTable_(0),
+schedulesTable_(0),
+pending_(0),
+rgbContainer_(0),
+previewGamut_(&ColourConvert::GAMUT_DEFAULT),
+hueSatContainer_(0),
+ctContainer_(0)
 {
+    for(int i = 0; i < BridgeState::AllResources; i++) {
+        loading_[i] = false;
+    }
     setContentAlignment(AlignLeft);
     parent_ = main;
     bridge_ = bridge;
+    client_ = parent_->getBridgeClient(bridge_->getIP(), bridge_->getPort());
+    //one poll loop per bridge keeps every session viewing it up to date
+    subscription_ = -1;
+    subscribe();
     setStyleClass("w3-animate-opacity");
 }
 
+/**
+ *   @brief  Light Management Widget destructor, stops watching the bridge and cancels the
+ *           callbacks of requests still waiting on the shared bridge client
+ *
+ */
+LightManagementWidget::~LightManagementWidget() {
+    if(subscription_ >= 0) BridgeRegistry::instance()->unsubscribe(subscription_);
+    client_->cancel(this);
+    //the colour pickers are only parented while their dialog is open
+    delete rgbContainer_;
+    delete hueSatContainer_;
+    delete ctContainer_;
+}
+
 
 /**
  *   @brief  Update function, clears the widget and re-populates with elements of the light management
@@ -67,6 +97,9 @@ schedulesWidget_(0)
 void LightManagementWidget::update()
 {
     clear(); // everytime you come back to page, reset the widgets
+    lightRows_.clear();
+    groupRows_.clear();
+    scheduleRows_.clear();
 
     WBorderLayout *layout = new WBorderLayout();
     WContainerWidget *left = new WContainerWidget();
@@ -77,9 +110,15 @@ void LightManagementWidget::update()
     layout->addWidget(central, WBorderLayout::Center);
 
 
+    //live updates push every change of the bridge, the refresh button is only needed without them
+    liveUpdatesBox_ = new WCheckBox("Live updates");
+    liveUpdatesBox_->setChecked(subscription_ >= 0);
+    liveUpdatesBox_->changed().connect(boost::bind(&LightManagementWidget::setLiveUpdates, this));
+
     //create refreshButton for refreshing Bridge JSON data
-    WPushButton *refreshButton = new WPushButton("Refresh Bridge");
-    refreshButton->clicked().connect(boost::bind(&LightManagementWidget::refreshBridge, this));
+    refreshButton_ = new WPushButton("Refresh Bridge");
+    refreshButton_->clicked().connect(boost::bind(&LightManagementWidget::refreshBridge, this));
+    refreshButton_->setHidden(subscription_ >= 0);
 
 
     //Menu to navigate through different pages
@@ -109,7 +148,14 @@ void LightManagementWidget::update()
     lightManagementStack_->setContentAlignment(AlignCenter);
     central->addWidget(lightManagementStack_);
     new WBreak(central);
-    central->addWidget(refreshButton);
+    central->addWidget(liveUpdatesBox_);
+    central->addWidget(refreshButton_);
+
+    //commands are answered through server push, the page stays usable while they are pending
+    pendingText_ = new WText(central);
+    pendingText_->setHidden(true);
+    statusText_ = new WText(central);
+    showPending();
 
     //create overviewWidget
     overviewWidget_ = new WContainerWidget(lightManagementStack_);
@@ -123,56 +169,30 @@ void LightManagementWidget::update()
     new WText("Bridge Name: " + bridge_->getName(), overviewWidget_);
     new WBreak(overviewWidget_);
     new WText("Bridge Location: " + bridge_->getLocation(), overviewWidget_);
+    if(bridge_->getState()->getSwversion() != "") {
+        new WBreak(overviewWidget_);
+        new WText("Software Version: " + bridge_->getState()->getSwversion(), overviewWidget_);
+    }
+    //commands of every account sharing this bridge wait in the same rate-limited queue
+    BridgeScheduler::Stats stats = BridgeScheduler::instance()->getStats(bridge_->getKey());
+    int queued = stats.queued[BridgeScheduler::Interactive] + stats.queued[BridgeScheduler::Bulk] + stats.queued[BridgeScheduler::Background];
+    new WBreak(overviewWidget_);
+    new WText("Queued Commands: " + boost::lexical_cast<string>(queued) +
+              " (average wait " + boost::lexical_cast<string>((int)stats.averageWait) + " ms)", overviewWidget_);
 
-    //create lightsWidget
-    lightsWidget_ = new WContainerWidget(lightManagementStack_);
-    lightsWidget_->setContentAlignment(AlignCenter);
-    //Lights title
-    WText *lightsTitle = new WText("Lights", lightsWidget_);
-    lightsTitle->setStyleClass("title");
-    new WBreak(lightsWidget_);
-    new WBreak(lightsWidget_);
-    //Lights table
-    lightsTable_ = new WTable(lightsWidget_);
-    lightsTable_->setHeaderCount(1); //set first row as header
-    updateLightsTable();
-
-    //create groupsWidget
-    groupsWidget_ = new WContainerWidget(lightManagementStack_);
-    groupsWidget_->setContentAlignment(AlignCenter);
-    //Groups title
-    WText *groupsTitle = new WText("Groups", groupsWidget_);
-    groupsTitle->setStyleClass("title");
-    new WBreak(groupsWidget_);
-    new WBreak(groupsWidget_);
-    //Groups table
-    WPushButton *newGroupButton = new WPushButton("Add +");
-    newGroupButton->clicked().connect(boost::bind(&LightManagementWidget::createGroupDialog, this));
-    groupsWidget_->addWidget(newGroupButton);
-    groupsTable_ = new WTable(groupsWidget_);
-    groupsTable_->setHeaderCount(1); //set first row as header
-    updateGroupsTable();
-
-    //create schedulesWidget
-    schedulesWidget_ = new WContainerWidget(lightManagementStack_);
-    schedulesWidget_->setContentAlignment(AlignCenter);
-    //Schedules title
-    WText *schedulesTitle = new WText("Schedules", schedulesWidget_);
-    schedulesTitle->setStyleClass("title");
-    new WBreak(schedulesWidget_);
-    new WBreak(schedulesWidget_);
-    //Groups table
-    WPushButton *newScheduleButton = new WPushButton("Add +");
-    newScheduleButton->clicked().connect(boost::bind(&LightManagementWidget::createScheduleDialog, this));
-    schedulesWidget_->addWidget(newScheduleButton);
-    schedulesTable_ = new WTable(schedulesWidget_);
-    schedulesTable_->setHeaderCount(1);
-    updateSchedulesTable();
+    //the lights, groups and schedules pages are built and fetched the first time they are viewed
+    lightsWidget_ = 0;
+    groupsWidget_ = 0;
+    schedulesWidget_ = 0;
+    lightsTable_ = 0;
+    groupsTable_ = 0;
+    schedulesTable_ = 0;
 
     //initialize page with Overview as initial view
     overviewMenuItem->select();
 
     //WContainer for RGB Colour Picker used for selecting Colours
+    delete rgbContainer_;
     rgbContainer_ = new WContainerWidget();
     new WText("Red: ", rgbContainer_);
     redSlider = new WSlider(rgbContainer_);
@@ -194,33 +214,19 @@ void LightManagementWidget::update()
     blueSlider->setMinimum(0);
     blueSlider->setMaximum(255);
 
-    WCssDecorationStyle *colour = new WCssDecorationStyle();
-
-    colour->setBackgroundColor(WColor(redSlider->value(), greenSlider->value(), blueSlider->value()));
-    rgbContainer_->setDecorationStyle(*colour);
-
-    redSlider->valueChanged().connect(bind([=] {
-        colour->setBackgroundColor(WColor(redSlider->value(),
-                                          greenSlider->value(),
-                                          blueSlider->value()));
-        rgbContainer_->setDecorationStyle(*colour);
-    }));
-
-    greenSlider->valueChanged().connect(bind([=] {
-        colour->setBackgroundColor(WColor(redSlider->value(),
-                                          greenSlider->value(),
-                                          blueSlider->value()));
-        rgbContainer_->setDecorationStyle(*colour);
-    }));
+    //the browser recolours the picker while the sliders move (js/colourpreview.js), the server
+    //only reads the sliders when the colour is committed
+    redSlider->setNativeControl(true);
+    greenSlider->setNativeControl(true);
+    blueSlider->setNativeControl(true);
+    rgbContainer_->setAttributeValue("data-preview", "rgb");
 
-    blueSlider->valueChanged().connect(bind([=] {
-        colour->setBackgroundColor(WColor(redSlider->value(),
-                                          greenSlider->value(),
-                                          blueSlider->value()));
-        rgbContainer_->setDecorationStyle(*colour);
-    }));
+    //the preview shows the colour the light will take, nothing is allocated per change
+    previewGamut_ = &ColourConvert::GAMUT_DEFAULT;
+    showRGBPreview();
 
     //WContainer for Hue/Saturation Colour Picker used for selecting colours
+    delete hueSatContainer_;
     hueSatContainer_ = new WContainerWidget();
     new WText("Hue: ", hueSatContainer_);
     hueSlider = new WSlider(hueSatContainer_);
@@ -243,40 +249,48 @@ void LightManagementWidget::update()
     briSlider->setMinimum(0);
     briSlider->setMaximum(254);
 
-    WCssDecorationStyle *hsColour = new WCssDecorationStyle();
-
-    struct rgb *hsRgb = ColourConvert::hsv2rgb((float)hueSlider->value(),(float) satSlider->value(),
-                                              (float)briSlider->value());
-    hsColour->setBackgroundColor(WColor(hsRgb->r, hsRgb->g, hsRgb->b));
-
-
-    hueSatContainer_->setDecorationStyle(*hsColour);
-
-    hueSlider->valueChanged().connect(bind([=] {
-        struct rgb *hsRgb = ColourConvert::hsv2rgb((float)hueSlider->value(),(float) satSlider->value(),
-                                              (float)briSlider->value());
-        hsColour->setBackgroundColor(WColor(hsRgb->r,
-                                          hsRgb->g,
-                                          hsRgb->b));
-        hueSatContainer_->setDecorationStyle(*hsColour);
-    }));
-    satSlider->valueChanged().connect(bind([=] {
-        struct rgb *hsRgb = ColourConvert::hsv2rgb((float)hueSlider->value(),(float) satSlider->value(),
-                                              (float)briSlider->value());
-        hsColour->setBackgroundColor(WColor(hsRgb->r,
-                                          hsRgb->g,
-                                          hsRgb->b));
-        hueSatContainer_->setDecorationStyle(*hsColour);
-    }));
-
-    briSlider->valueChanged().connect(bind([=] {
-        struct rgb *hsRgb = ColourConvert::hsv2rgb((float)hueSlider->value(),(float) satSlider->value(),
-                                              (float)briSlider->value());
-        hsColour->setBackgroundColor(WColor(hsRgb->r,
-                                          hsRgb->g,
-                                          hsRgb->b));
-        hueSatContainer_->setDecorationStyle(*hsColour);
-    }));
+    hueSlider->setNativeControl(true);
+    satSlider->setNativeControl(true);
+    briSlider->setNativeControl(true);
+    hueSatContainer_->setAttributeValue("data-preview", "hs");
+    showHueSatPreview();
+
+    //WContainer for Colour Temperature picker used for white ambiance lights
+    delete ctContainer_;
+    ctContainer_ = new WContainerWidget();
+    new WText("Colour Temperature: ", ctContainer_);
+    ctSlider = new WSlider(ctContainer_);
+    new WBreak(ctContainer_);
+    //the scale under the slider shows the whole range of temperatures at a glance
+    WCssStyleSheet &styleSheet = WApplication::instance()->styleSheet();
+    if(!styleSheet.isDefined("ct-scale")) {
+        string gradient = "linear-gradient(to right";
+        for(int i = 0; i <= 8; i++) {
+            struct rgb stop = ColourConvert::ct2rgb(ColourConvert::CT_MIN + i * (ColourConvert::CT_MAX - ColourConvert::CT_MIN) / 8.0f, 254);
+            gradient += ", rgb(" + boost::lexical_cast<string>((int)stop.r) + "," + boost::lexical_cast<string>((int)stop.g)
+                        + "," + boost::lexical_cast<string>((int)stop.b) + ")";
+        }
+        styleSheet.addRule(".ct-scale", "background: " + gradient + ");", "ct-scale");
+    }
+    WContainerWidget *ctScale = new WContainerWidget(ctContainer_);
+    ctScale->setStyleClass("ct-scale");
+    ctScale->resize(200,10);
+    new WText("Brightness: ", ctContainer_);
+    ctBriSlider = new WSlider(ctContainer_);
+    new WBreak(ctContainer_);
+
+    ctSlider->resize(200,20);
+    ctBriSlider->resize(200,20);
+
+    ctSlider->setMinimum(ColourConvert::CT_MIN);
+    ctSlider->setMaximum(ColourConvert::CT_MAX);
+    ctBriSlider->setMinimum(0);
+    ctBriSlider->setMaximum(254);
+
+    ctSlider->setNativeControl(true);
+    ctBriSlider->setNativeControl(true);
+    ctContainer_->setAttributeValue("data-preview", "ct");
+    showCtPreview();
 
     setLayout(layout, AlignTop | AlignJustify);
 }
@@ -294,63 +308,114 @@ void LightManagementWidget::viewOverviewWidget(){
 
 /**
  *   @brief  View lights function, sets the current widget to the light widget when clicked on
- *           the menu.
+ *           the menu. The page is built and the lights are fetched the first time it is viewed.
  *
  *   @return  void
  *
  */
 void LightManagementWidget::viewLightsWidget(){
+    if(!lightsWidget_) {
+        lightsWidget_ = new WContainerWidget(lightManagementStack_);
+        lightsWidget_->setContentAlignment(AlignCenter);
+        //Lights title
+        WText *lightsTitle = new WText("Lights", lightsWidget_);
+        lightsTitle->setStyleClass("title");
+        new WBreak(lightsWidget_);
+        new WBreak(lightsWidget_);
+        //Lights table
+        lightsTable_ = new WTable(lightsWidget_);
+        lightsTable_->setHeaderCount(1); //set first row as header
+        updateLightsTable();
+    }
     lightManagementStack_->setCurrentWidget(lightsWidget_);
+    loadResource(BridgeState::Lights);
 }
 /**
  *   @brief  View groups function, sets the current widget shown to groups widget when clicked on
- *           the menu.
+ *           the menu. The page is built and the groups are fetched the first time it is viewed.
  *
  *   @return  void
  *
  */
 void LightManagementWidget::viewGroupsWidget(){
+    if(!groupsWidget_) {
+        groupsWidget_ = new WContainerWidget(lightManagementStack_);
+        groupsWidget_->setContentAlignment(AlignCenter);
+        //Groups title
+        WText *groupsTitle = new WText("Groups", groupsWidget_);
+        groupsTitle->setStyleClass("title");
+        new WBreak(groupsWidget_);
+        new WBreak(groupsWidget_);
+        //Groups table
+        WPushButton *newGroupButton = new WPushButton("Add +");
+        newGroupButton->clicked().connect(boost::bind(&LightManagementWidget::createGroupDialog, this));
+        groupsWidget_->addWidget(newGroupButton);
+        groupsTable_ = new WTable(groupsWidget_);
+        groupsTable_->setHeaderCount(1); //set first row as header
+        updateGroupsTable();
+    }
     lightManagementStack_->setCurrentWidget(groupsWidget_);
+    loadResource(BridgeState::Groups);
+    //the group dialogs list the lights to pick from
+    loadResource(BridgeState::Lights);
 }
 
 /**
  *   @brief  View schedule function, sets the current widget shown to schedule widget when clicked on
- *           the menu.
+ *           the menu. The page is built and the schedules are fetched the first time it is viewed.
  *
  *   @return  void
  *
  */
 void LightManagementWidget::viewSchedulesWidget(){
+    if(!schedulesWidget_) {
+        schedulesWidget_ = new WContainerWidget(lightManagementStack_);
+        schedulesWidget_->setContentAlignment(AlignCenter);
+        //Schedules title
+        WText *schedulesTitle = new WText("Schedules", schedulesWidget_);
+        schedulesTitle->setStyleClass("title");
+        new WBreak(schedulesWidget_);
+        new WBreak(schedulesWidget_);
+        //Schedules table
+        WPushButton *newScheduleButton = new WPushButton("Add +");
+        newScheduleButton->clicked().connect(boost::bind(&LightManagementWidget::createScheduleDialog, this));
+        schedulesWidget_->addWidget(newScheduleButton);
+        schedulesTable_ = new WTable(schedulesWidget_);
+        schedulesTable_->setHeaderCount(1);
+        updateSchedulesTable();
+    }
     lightManagementStack_->setCurrentWidget(schedulesWidget_);
+    loadResource(BridgeState::Schedules);
 }
 
 /**
  *   @brief  Opens a WDialog box to edit rgb values for the specified light
  *
- *   @param   light is the current light object to edit
+ *   @param   num is the number of the light to edit
  *
  *   @return  void
  *
  */
-void LightManagementWidget::editRGBDialog(Light *light) {
+void LightManagementWidget::editRGBDialog(int num) {
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
 
     editRGBDialog_ = new WDialog("Change Colour"); // title
 
     editRGBDialog_->contents()->addWidget(rgbContainer_);
 
     //get current RGB values and set the Slider and BG colours to match
-    struct rgb *currentRGBVals = ColourConvert::xy2rgb((float)light->getX(),
+    struct rgb currentRGBVals = ColourConvert::xy2rgb((float)light->getX(),
                                                        (float)light->getY(),
                                                        (float)light->getBri());
-    redSlider->setValue(currentRGBVals->r);
-    greenSlider->setValue(currentRGBVals->g);
-    blueSlider->setValue(currentRGBVals->b);
+    redSlider->setValue(currentRGBVals.r);
+    greenSlider->setValue(currentRGBVals.g);
+    blueSlider->setValue(currentRGBVals.b);
     redSlider->setDisabled(false);
     greenSlider->setDisabled(false);
     blueSlider->setDisabled(false);
-    WCssDecorationStyle *colour = new WCssDecorationStyle();
-    colour->setBackgroundColor(WColor(redSlider->value(), greenSlider->value(), blueSlider->value()));
-    rgbContainer_->setDecorationStyle(*colour);
+    previewGamut_ = &ColourConvert::gamutFor(light->getModelid().toUTF8());
+    showRGBPreview();
 
     new WBreak(editRGBDialog_->contents());
 
@@ -362,19 +427,22 @@ void LightManagementWidget::editRGBDialog(Light *light) {
     cancel->clicked().connect(editRGBDialog_, &WDialog::reject);
 
     // when the user is finished, call the updateBridge function
-    editRGBDialog_->finished().connect(boost::bind(&LightManagementWidget::updateLightXY, this, light));
+    editRGBDialog_->finished().connect(boost::bind(&LightManagementWidget::updateLightXY, this, num));
+    editRGBDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, editRGBDialog_));
     editRGBDialog_->show();
 }
 
 /**
  *   @brief  Opens a WDialog box to convert hue, saturation, and brightness to rgb color
  *
- *   @param   light is the current light object to edit
+ *   @param   num is the number of the light to edit
  *
  *   @return  void
  *
  */
-void LightManagementWidget::editHueSatDialog(Light *light) {
+void LightManagementWidget::editHueSatDialog(int num) {
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
 
     editHueSatDialog_ = new WDialog("Change Hue/Saturation"); // title
 
@@ -393,12 +461,7 @@ void LightManagementWidget::editHueSatDialog(Light *light) {
     satSlider->setDisabled(false);
     briSlider->setDisabled(false);
 
-    WCssDecorationStyle *hsColour = new WCssDecorationStyle();
-
-    if (light->getColormode() == "hs") {
-        hsColour->setBackgroundColor(WColor(hueSlider->value(), satSlider->value(), briSlider->value()));
-        hueSatContainer_->setDecorationStyle(*hsColour);
-    }
+    showHueSatPreview();
 
     new WBreak(editHueSatDialog_->contents());
 
@@ -410,109 +473,237 @@ void LightManagementWidget::editHueSatDialog(Light *light) {
     cancel->clicked().connect(editHueSatDialog_, &WDialog::reject);
 
     // when the user is finished, call the updateBridge function
-    editHueSatDialog_->finished().connect(boost::bind(&LightManagementWidget::updateLightHS, this, light));
+    editHueSatDialog_->finished().connect(boost::bind(&LightManagementWidget::updateLightHS, this, num));
+    editHueSatDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, editHueSatDialog_));
     editHueSatDialog_->show();
 }
 
 /**
- *   @brief  Update lights table function, clears the current table and re-populates it with
- *           all the lights that are in the bridge. The user can edit the properties of lights
- *           from this table.
+ *   @brief  Opens a WDialog box to change the colour temperature and brightness of a light
+ *
+ *   @param   num is the number of the light to edit
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::editCtDialog(int num) {
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
+
+    editCtDialog_ = new WDialog("Change Colour Temperature"); // title
+
+    editCtDialog_->contents()->addWidget(ctContainer_);
+
+    //start from the current temperature, or the closest one to the current colour
+    int ct = light->getCt();
+    if(ct < 0) ct = (int)ColourConvert::xy2ct((float)light->getX(), (float)light->getY());
+    ctSlider->setValue(ct);
+    ctBriSlider->setValue(light->getBri());
+    ctSlider->setDisabled(false);
+    ctBriSlider->setDisabled(false);
+    showCtPreview();
+
+    new WBreak(editCtDialog_->contents());
+
+    // make okay and cancel buttons, cancel sends a reject dialogstate, okay sends an accept
+    WPushButton *ok = new WPushButton("OK", editCtDialog_->contents());
+    WPushButton *cancel = new WPushButton("Cancel", editCtDialog_->contents());
+
+    ok->clicked().connect(editCtDialog_ ,&WDialog::accept);
+    cancel->clicked().connect(editCtDialog_, &WDialog::reject);
+
+    // when the user is finished, call the updateBridge function
+    editCtDialog_->finished().connect(boost::bind(&LightManagementWidget::updateLightCt, this, num));
+    editCtDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, editCtDialog_));
+    editCtDialog_->show();
+}
+
+/**
+ *   @brief  Update lights table function, brings the table in line with the lights that are in the
+ *           bridge. Rows are kept per light number so only rows of added or removed lights are
+ *           created or deleted and only cells whose values changed are touched. The user can edit
+ *           the properties of lights from this table.
  *
  *   @return  void
  *
  */
 void LightManagementWidget::updateLightsTable() {
-    lightsTable_->clear();
-
-    //create new row for headers <tr>
-    WTableRow *tableRow = lightsTable_->insertRow(lightsTable_->rowCount());
-    //table headers <th>
-    tableRow->elementAt(0)->addWidget(new Wt::WText("Light #"));
-    tableRow->elementAt(1)->addWidget(new Wt::WText("Name"));
-    tableRow->elementAt(2)->addWidget(new Wt::WText("Transition"));
-    tableRow->elementAt(3)->addWidget(new Wt::WText("Brightness"));
-    tableRow->elementAt(4)->addWidget(new Wt::WText("Actions"));
-
-
-    //convert json string into json object
-    Json::Object bridgeJson;
-    Json::parse(bridge_->getJson(), bridgeJson);
-    Json::Object lights = bridgeJson.get("lights");
-
-    set<string> data = lights.names();
-    for(string num : data) {
-        Json::Object lightData = lights.get(num);
-        Light *light = new Light(num, lightData);
-
-        //create new row for entry <tr>
-        tableRow = lightsTable_->insertRow(lightsTable_->rowCount());
-
-        //table data <td>
-        tableRow->elementAt(0)->addWidget(new WText(light->getLightnum()));
-        tableRow->elementAt(1)->addWidget(new WText(light->getName()));
-
-        //transition definer
-        WLineEdit *editLightTransition = new WLineEdit();
-        editLightTransition->resize(40,20);
-        //display transition time to user (transition time is stored as multiple of 100ms)
-        editLightTransition->setValueText(boost::lexical_cast<string>(light->getTransition()));
-        tableRow->elementAt(2)->addWidget(editLightTransition);
-        editLightTransition->setDisabled(!light->getOn());  //disable if light off
-        intValidator = new WIntValidator(0, 100, tableRow->elementAt(2)); //100 second maximum
-        intValidator->setMandatory(true);
-        editLightTransition->setValidator(intValidator);
-        editLightTransition->changed().connect(bind([=] {
-            light->setTransition(boost::lexical_cast<int>(editLightTransition->valueText()));
-        }));
-        tableRow->elementAt(2)->addWidget(new WText(" seconds"));
-
-        //brightness slider
-        WSlider *brightnessSlider_ = new WSlider();
-        brightnessSlider_->resize(160,20);
-        brightnessSlider_->setMinimum(0);
-        brightnessSlider_->setMaximum(254);
-        brightnessSlider_->setValue(light->getBri());
-        brightnessSlider_->setDisabled(!light->getOn()); //disable if light off
-        brightnessSlider_->valueChanged().connect(boost::bind(&LightManagementWidget::updateLightBri, this, brightnessSlider_, light));
-        tableRow->elementAt(3)->addWidget(brightnessSlider_);
-
-        string onButton = light->getOn() == 1 ? "On" : "Off";
-        WPushButton *switchButton_ = new WPushButton(onButton);
-        switchButton_->clicked().connect(boost::bind(&LightManagementWidget::updateLightOn, this, switchButton_, light));
-
-        WPushButton *editLightButton_ = new WPushButton("Edit");
-        editLightButton_->clicked().connect(boost::bind(&LightManagementWidget::editLightDialog, this, light));
-
-        WSplitButton *colourButton_ = new WSplitButton("Colour");
-        WPopupMenu *colourPopup = new WPopupMenu();
-        colourButton_->dropDownButton()->setMenu(colourPopup);
-        WPopupMenuItem *hsv = new WPopupMenuItem("Hue/Saturation");
-        colourPopup->addItem(hsv);
-        hsv->triggered().connect(boost::bind(&LightManagementWidget::editHueSatDialog, this, light));
-        colourButton_->setDisabled(!light->getOn());  //disable if light off
-        colourButton_->actionButton()->clicked().connect(boost::bind(&LightManagementWidget::editRGBDialog, this, light));
-
-        tableRow->elementAt(4)->addWidget(switchButton_);
-        tableRow->elementAt(4)->addWidget(colourButton_);
-        tableRow->elementAt(4)->addWidget(editLightButton_);
-
-        WPushButton *removeLightButton = new WPushButton("Remove");
-        removeLightButton->clicked().connect(boost::bind(&LightManagementWidget::removeLight, this, light));
-        tableRow->elementAt(4)->addWidget(removeLightButton);
+    if(!lightsTable_ || !bridge_->getState()->isLoaded(BridgeState::Lights)) return;
+    map<int, Light> &lights = bridge_->getState()->getLights();
+
+    //create row for headers <tr> the first time the table is filled
+    if(lightsTable_->rowCount() == 0) {
+        WTableRow *tableRow = lightsTable_->insertRow(0);
+        //table headers <th>
+        tableRow->elementAt(0)->addWidget(new Wt::WText("Light #"));
+        tableRow->elementAt(1)->addWidget(new Wt::WText("Name"));
+        tableRow->elementAt(2)->addWidget(new Wt::WText("Transition"));
+        tableRow->elementAt(3)->addWidget(new Wt::WText("Brightness"));
+        tableRow->elementAt(4)->addWidget(new Wt::WText("Actions"));
+    }
+
+    //remove rows of lights that are no longer on the bridge
+    for(auto it = lightRows_.begin(); it != lightRows_.end();) {
+        if(lights.count(it->first) == 0) {
+            lightsTable_->deleteRow(it->second.row->rowNum());
+            it = lightRows_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    //lights and rows are both ordered by light number, so new rows are inserted in place
+    int index = 1;
+    for(auto &entry : lights) {
+        auto row = lightRows_.find(entry.first);
+        if(row == lightRows_.end()) {
+            insertLightRow(entry.first, &entry.second, index);
+        }
+        else {
+            updateLightRow(row->second, &entry.second);
+        }
+        index++;
     }
 }
 
+/**
+ *   @brief  Insert light row function, creates the row for a light at the given index of the
+ *           lights table. Actions look the light up by number when triggered, so the row stays
+ *           valid across bridge refreshes.
+ *
+ *   @param  num is the light number
+ *   @param  light is the light object to show in the row
+ *   @param  index is the table row to insert at
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::insertLightRow(int num, Light *light, int index) {
+    LightRow row;
+
+    //create new row for entry <tr>
+    row.row = lightsTable_->insertRow(index);
+
+    //table data <td>
+    row.row->elementAt(0)->addWidget(new WText(light->getLightnum()));
+    row.name = new WText(light->getName());
+    row.row->elementAt(1)->addWidget(row.name);
+
+    //transition definer
+    WLineEdit *editLightTransition = new WLineEdit();
+    editLightTransition->resize(40,20);
+    //display transition time to user (transition time is stored as multiple of 100ms)
+    editLightTransition->setValueText(boost::lexical_cast<string>(light->getTransition()));
+    row.row->elementAt(2)->addWidget(editLightTransition);
+    editLightTransition->setDisabled(!light->getOn());  //disable if light off
+    intValidator = new WIntValidator(0, 100, row.row->elementAt(2)); //100 second maximum
+    intValidator->setMandatory(true);
+    editLightTransition->setValidator(intValidator);
+    row.row->elementAt(2)->addWidget(new WText(" seconds"));
+    row.transition = editLightTransition;
+
+    //brightness slider
+    row.brightness = new WSlider();
+    row.brightness->resize(160,20);
+    row.brightness->setMinimum(0);
+    row.brightness->setMaximum(254);
+    row.brightness->setValue(light->getBri());
+    row.brightness->setDisabled(!light->getOn()); //disable if light off
+    row.brightness->valueChanged().connect(boost::bind(&LightManagementWidget::updateLightBri, this, row.brightness, num));
+    row.row->elementAt(3)->addWidget(row.brightness);
+
+    string onButton = light->getOn() == 1 ? "On" : "Off";
+    row.onButton = new WPushButton(onButton);
+    row.onButton->clicked().connect(boost::bind(&LightManagementWidget::updateLightOn, this, row.onButton, num));
+
+    WPushButton *editLightButton_ = new WPushButton("Edit");
+    editLightButton_->clicked().connect(boost::bind(&LightManagementWidget::editLightDialog, this, num));
+
+    row.colourButton = new WSplitButton("Colour");
+    WPopupMenu *colourPopup = new WPopupMenu();
+    row.colourButton->dropDownButton()->setMenu(colourPopup);
+    WPopupMenuItem *hsv = new WPopupMenuItem("Hue/Saturation");
+    colourPopup->addItem(hsv);
+    hsv->triggered().connect(boost::bind(&LightManagementWidget::editHueSatDialog, this, num));
+    //only lights that report a colour temperature can be set by one
+    if(light->getCt() >= 0) {
+        WPopupMenuItem *ct = new WPopupMenuItem("Colour Temperature");
+        colourPopup->addItem(ct);
+        ct->triggered().connect(boost::bind(&LightManagementWidget::editCtDialog, this, num));
+    }
+    row.colourButton->setDisabled(!light->getOn());  //disable if light off
+    row.colourButton->actionButton()->clicked().connect(boost::bind(&LightManagementWidget::editRGBDialog, this, num));
+
+    row.row->elementAt(4)->addWidget(row.onButton);
+    row.row->elementAt(4)->addWidget(row.colourButton);
+    row.row->elementAt(4)->addWidget(editLightButton_);
+
+    WPushButton *removeLightButton = new WPushButton("Remove");
+    removeLightButton->clicked().connect(boost::bind(&LightManagementWidget::removeLight, this, num));
+    row.row->elementAt(4)->addWidget(removeLightButton);
+
+    lightRows_[num] = row;
+}
+
+/**
+ *   @brief  Update light row function, changes only the cells of an existing row whose
+ *           values differ from the light.
+ *
+ *   @param  row is the row showing the light
+ *   @param  light is the current light object
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::updateLightRow(LightRow &row, Light *light) {
+    if(row.name->text() != light->getName())
+        row.name->setText(light->getName());
+
+    if(row.brightness->value() != light->getBri())
+        row.brightness->setValue(light->getBri());
+
+    WString onButton = light->getOn() ? "On" : "Off";
+    if(row.onButton->text() != onButton)
+        row.onButton->setText(onButton);
+
+    //controls are only usable while the light is on
+    if(row.brightness->isDisabled() == light->getOn()) {
+        row.transition->setDisabled(!light->getOn());
+        row.brightness->setDisabled(!light->getOn());
+        row.colourButton->setDisabled(!light->getOn());
+    }
+}
+
+/**
+ *   @brief  Light transition function, reads the transition time entered in a light's row.
+ *           The transition is only kept in the page, the shared bridge state is not changed.
+ *
+ *   @param  num is the number of the light
+ *
+ *   @return  int the transition time, 4 if the row has no valid value
+ *
+ */
+int LightManagementWidget::lightTransition(int num) {
+    auto row = lightRows_.find(num);
+    if(row == lightRows_.end() || row->second.transition->validate() != WValidator::Valid)
+        return 4;
+    return boost::lexical_cast<int>(row->second.transition->valueText());
+}
+
 /**
  *   @brief  Edit lights function, when the edit button is clicked, a window where the user can
  *           change any property of the selected light appears.
  *
- *   @param  light is the light object that was selected to edit from the table.
+ *   @param  num is the number of the light that was selected to edit from the table.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::editLightDialog(Light *light) {
+void LightManagementWidget::editLightDialog(int num) {
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
+
     editLightDialog_ = new WDialog("Edit Light #" + boost::lexical_cast<string>(light->getLightnum())); // title
 
     new WLabel("Light Name: ", editLightDialog_->contents());
@@ -528,7 +719,8 @@ void LightManagementWidget::editLightDialog(Light *light) {
     cancel->clicked().connect(editLightDialog_, &WDialog::reject);
 
     // when the user is finished, call the updateLight function
-    editLightDialog_->finished().connect(boost::bind(&LightManagementWidget::updateLightInfo, this, light));
+    editLightDialog_->finished().connect(boost::bind(&LightManagementWidget::updateLightInfo, this, num));
+    editLightDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, editLightDialog_));
     editLightDialog_->show();
 }
 
@@ -536,12 +728,15 @@ void LightManagementWidget::editLightDialog(Light *light) {
  *   @brief  Remove lights function, removes the selected light from the current
  *           bridge. Does not work on Hue Emulator but will work with real bridges.
  *
- *   @param  light is the light object to remove from the bridge.
+ *   @param  num is the number of the light to remove from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::removeLight(Light *light) {
+void LightManagementWidget::removeLight(int num) {
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
+
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + light->getLightnum().toUTF8();
     deleteRequest(url);
 }
@@ -550,32 +745,21 @@ void LightManagementWidget::removeLight(Light *light) {
  *   @brief  Update lights function, creates a JSON request to change properties of
  *           a given light based on user's inputs in the edit light dialog box.
  *
- *   @param  light is the light object to update from the bridge.
+ *   @param  num is the number of the light to update from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::updateLightInfo(Light *light){
+void LightManagementWidget::updateLightInfo(int num){
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
+
     if (editLightDialog_->result() == WDialog::DialogCode::Rejected)
         return;
 
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + boost::lexical_cast<string>(light->getLightnum());
 
-    Http::Message *data = new Http::Message();
-    data->addBodyText("{\"name\":\"" + boost::lexical_cast<string>(editLightName->text().toUTF8()) + "\"}");
-
-    cout << "Light: Updating light name at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
-
-    if(client->put(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "Light: Error in client->put(url) call\n";
-    }
+    putRequest(url, "{\"name\":\"" + boost::lexical_cast<string>(editLightName->text().toUTF8()) + "\"}");
 }
 
 /**
@@ -583,28 +767,20 @@ void LightManagementWidget::updateLightInfo(Light *light){
  *           brightness value given the brightness slider's value.
  *
  *   @param  slider_ is the brightness slider that contains a value between 0-254.
- *   @param  light is the light object to update the brightness value.
+ *   @param  num is the number of the light to update the brightness value.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::updateLightBri(WSlider *slider_, Light *light){
-    string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + light->getLightnum().toUTF8() + "/state";
-    Http::Message *data = new Http::Message();
-    data->addBodyText("{\"bri\":" + boost::lexical_cast<string>(slider_->value()) + ", \"transitiontime\":" + boost::lexical_cast<string>(light->getTransition()) + "}");
-
-    cout << "Light: Updating light brightness at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
+void LightManagementWidget::updateLightBri(WSlider *slider_, int num){
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
 
-    if(client->put(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "Light: Error in client->put(url) call\n";
-    }
+    string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + light->getLightnum().toUTF8() + "/state";
+    Json::Object state;
+    state["bri"] = Json::Value(slider_->value());
+    state["transitiontime"] = Json::Value(lightTransition(num));
+    putLightState(url, state);
 }
 
 /**
@@ -612,180 +788,265 @@ void LightManagementWidget::updateLightBri(WSlider *slider_, Light *light){
  *           on/off value.
  *
  *   @param  button_ is the clickable button that contains on/off value.
- *   @param  light is the light object to update the on/off value.
+ *   @param  num is the number of the light to update the on/off value.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::updateLightOn(WPushButton *button_, Light *light){
-    //set value string to reflect current state of the button
-    string value = button_->text() == "On" ? "False" : "True";
+void LightManagementWidget::updateLightOn(WPushButton *button_, int num){
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
+
+    //set value to reflect current state of the button
+    bool value = button_->text() == "On" ? false : true;
+
+    //show the new state right away, the row is put back if the bridge rejects it
+    button_->setText(value ? "On" : "Off");
+    auto row = lightRows_.find(num);
+    if(row != lightRows_.end()) {
+        row->second.transition->setDisabled(!value);
+        row->second.brightness->setDisabled(!value);
+        row->second.colourButton->setDisabled(!value);
+    }
 
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + light->getLightnum().toUTF8() + "/state";
-    Http::Message *data = new Http::Message();
 
+    Json::Object state;
+    state["on"] = Json::Value(value);
     //can only set transition time while light is on
     if(light->getOn()) {
-        data->addBodyText("{\"on\":" + value + ", \"transitiontime\":" + boost::lexical_cast<string>(light->getTransition()) + "}");
-    }
-    else {
-        data->addBodyText("{\"on\":" + value + "}");
-    }
-
-    cout << "Light: Updating light brightness at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
-
-    if(client->put(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "Light: Error in client->put(url) call\n";
+        state["transitiontime"] = Json::Value(lightTransition(num));
     }
+    putLightState(url, state);
 }
 
 /**
  *   @brief  Update light's XY function, creates a JSON request to update the selected light's
  *           color value given the XY values.
  *
- *   @param  light is the light object to update the XY value.
+ *   @param  num is the number of the light to update the XY value.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::updateLightXY(Light *light){
+void LightManagementWidget::updateLightXY(int num){
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
+
     if (editRGBDialog_->result() == WDialog::DialogCode::Rejected)
         return;
 
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + light->getLightnum().toUTF8() + "/state";
 
-    struct xy *cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value());
-    
-    Http::Message *data = new Http::Message();
-    data->addBodyText("{\"xy\":[" + boost::lexical_cast<string>(cols->x) + "," + boost::lexical_cast<string>(cols->y) + "]" + ", \"transitiontime\":" + boost::lexical_cast<string>(light->getTransition()) + ",\"bri\":" + boost::lexical_cast<string>((int)(cols->brightness)) + "}");
-
-    cout << "Light: Updating light brightness at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
-
-    if(client->put(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "Light: Error in client->put(url) call\n";
-    }
+    struct xy cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value(),
+                                           ColourConvert::gamutFor(light->getModelid().toUTF8()));
+
+    Json::Object state;
+    Json::Array xyJSON;
+    xyJSON.push_back(Json::Value((double)cols.x));
+    xyJSON.push_back(Json::Value((double)cols.y));
+    state["xy"] = Json::Value(xyJSON);
+    state["transitiontime"] = Json::Value(lightTransition(num));
+    state["bri"] = Json::Value((int)(cols.brightness));
+    putLightState(url, state);
 }
 
 /**
  *   @brief  Update HS function, creates a JSON request to update the selected light's
  *           hue, saturation, brightness, and transition time values.
  *
- *   @param  light is the light object to update.
+ *   @param  num is the number of the light to update.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::updateLightHS(Light *light){
+void LightManagementWidget::updateLightHS(int num){
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
+
     if (editHueSatDialog_->result() == WDialog::DialogCode::Rejected)
         return;
 
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + light->getLightnum().toUTF8() + "/state";
 
+    Json::Object state;
+    state["hue"] = Json::Value(hueSlider->value());
+    state["sat"] = Json::Value(satSlider->value());
+    state["bri"] = Json::Value(briSlider->value());
+    state["transitiontime"] = Json::Value(lightTransition(num));
+    putLightState(url, state);
+}
 
+/**
+ *   @brief  Update CT function, creates a JSON request to update the selected light's
+ *           colour temperature, brightness, and transition time values.
+ *
+ *   @param  num is the number of the light to update.
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::updateLightCt(int num){
+    Light *light = bridge_->getState()->getLight(num);
+    if(!light) return;
 
-    Http::Message *data = new Http::Message();
-    data->addBodyText("{\"hue\":" + boost::lexical_cast<string>(hueSlider->value()) + ", \"sat\":" +
-                      boost::lexical_cast<string>(satSlider->value()) +
-                      ", \"bri\":" + boost::lexical_cast<string>(briSlider->value()) +
-                      ", \"transitiontime\":" + boost::lexical_cast<string>(light->getTransition()) + "}");
+    if (editCtDialog_->result() == WDialog::DialogCode::Rejected)
+        return;
 
-    cout << "Light: Updating light hue/sat at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
+    string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/lights/" + light->getLightnum().toUTF8() + "/state";
 
-    if(client->put(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "Light: Error in client->put(url) call\n";
-    }
+    Json::Object state;
+    state["ct"] = Json::Value(ctSlider->value());
+    state["bri"] = Json::Value(ctBriSlider->value());
+    state["transitiontime"] = Json::Value(lightTransition(num));
+    putLightState(url, state);
 }
 
 /**
- *   @brief  Update groups table function, clears the current table and re-populates it with
- *           all the groups that are in the bridge.
+ *   @brief  Update groups table function, brings the table in line with the groups that are in
+ *           the bridge. Only rows of added or removed groups are created or deleted and only
+ *           cells whose values changed are touched.
  *
  *   @return  void
  *
  */
 void LightManagementWidget::updateGroupsTable() {
-    groupsTable_->clear();
-
-    //create new row for headers <tr>
-    WTableRow *tableRow = groupsTable_->insertRow(groupsTable_->rowCount());
-    //table headers <th>
-    tableRow->elementAt(0)->addWidget(new Wt::WText("Group #"));
-    tableRow->elementAt(1)->addWidget(new Wt::WText("Name"));
-    tableRow->elementAt(2)->addWidget(new Wt::WText("Lights"));
-    tableRow->elementAt(3)->addWidget(new Wt::WText("Transitions"));
-    tableRow->elementAt(4)->addWidget(new Wt::WText("Actions"));
-    //convert json string into json object
-    Json::Object bridgeJson;
-    Json::parse(bridge_->getJson(), bridgeJson);
-    Json::Object groups = bridgeJson.get("groups");
-
-    set<string> data = groups.names();
-    for(string num : data) {
-        Json::Object groupData = groups.get(num);
-        Group *group = new Group(num, groupData);
-
-        //create new row for entry <tr>
-        tableRow = groupsTable_->insertRow(groupsTable_->rowCount());
-
-        //table data <td>
-        tableRow->elementAt(0)->addWidget(new WText(group->getGroupnum()));
-        tableRow->elementAt(1)->addWidget(new WText(group->getName()));
-
-        for(WString lightNum : group->getLights()) {
-            tableRow->elementAt(2)->addWidget(new WText(lightNum));
-            tableRow->elementAt(2)->addWidget(new WBreak());
+    if(!groupsTable_ || !bridge_->getState()->isLoaded(BridgeState::Groups)) return;
+    map<int, Group> &groups = bridge_->getState()->getGroups();
+
+    //create row for headers <tr> the first time the table is filled
+    if(groupsTable_->rowCount() == 0) {
+        WTableRow *tableRow = groupsTable_->insertRow(0);
+        //table headers <th>
+        tableRow->elementAt(0)->addWidget(new Wt::WText("Group #"));
+        tableRow->elementAt(1)->addWidget(new Wt::WText("Name"));
+        tableRow->elementAt(2)->addWidget(new Wt::WText("Lights"));
+        tableRow->elementAt(3)->addWidget(new Wt::WText("Transitions"));
+        tableRow->elementAt(4)->addWidget(new Wt::WText("Actions"));
+    }
+
+    //remove rows of groups that are no longer on the bridge
+    for(auto it = groupRows_.begin(); it != groupRows_.end();) {
+        if(groups.count(it->first) == 0) {
+            groupsTable_->deleteRow(it->second.row->rowNum());
+            it = groupRows_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    //groups and rows are both ordered by group number, so new rows are inserted in place
+    int index = 1;
+    for(auto &entry : groups) {
+        auto row = groupRows_.find(entry.first);
+        if(row == groupRows_.end()) {
+            insertGroupRow(entry.first, &entry.second, index);
+        }
+        else {
+            updateGroupRow(row->second, &entry.second);
         }
+        index++;
+    }
+}
+
+/**
+ *   @brief  Insert group row function, creates the row for a group at the given index of the
+ *           groups table.
+ *
+ *   @param  num is the group number
+ *   @param  group is the group object to show in the row
+ *   @param  index is the table row to insert at
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::insertGroupRow(int num, Group *group, int index) {
+    GroupRow row;
+
+    //create new row for entry <tr>
+    row.row = groupsTable_->insertRow(index);
+
+    //table data <td>
+    row.row->elementAt(0)->addWidget(new WText(group->getGroupnum()));
+    row.name = new WText(group->getName());
+    row.row->elementAt(1)->addWidget(row.name);
+
+    row.lights = group->getLights();
+    for(int lightNum : row.lights) {
+        row.row->elementAt(2)->addWidget(new WText(boost::lexical_cast<string>(lightNum)));
+        row.row->elementAt(2)->addWidget(new WBreak());
+    }
+
+    //transition definer
+    WLineEdit *editGroupTransition = new WLineEdit();
+    editGroupTransition->resize(40,20);
+    //display transition time to user in seconds (transition time is stored as multiple of 100ms)
+    editGroupTransition->setValueText(boost::lexical_cast<string>(group->getTransition()));
+    row.row->elementAt(3)->addWidget(editGroupTransition);
+    intValidator = new WIntValidator(0, 100, row.row->elementAt(3)); //100 second maximum
+    intValidator->setMandatory(true);
+    editGroupTransition->setValidator(intValidator);
+    row.row->elementAt(3)->addWidget(new WText(" seconds"));
+    row.transition = editGroupTransition;
+
+    WPushButton *editGroupButton_ = new WPushButton("Edit");
+    editGroupButton_->clicked().connect(boost::bind(&LightManagementWidget::editGroupDialog, this, num));
+    row.row->elementAt(4)->addWidget(editGroupButton_);
+
+    WPushButton *advancedButton_ = new WPushButton("Advanced");
+    advancedButton_->clicked().connect(boost::bind(&LightManagementWidget::groupAdvancedDialog, this, num));
+    row.row->elementAt(4)->addWidget(advancedButton_);
+
+    // remove group
+    WPushButton *removeGroupButton = new WPushButton("Remove");
+    removeGroupButton->clicked().connect(boost::bind(&LightManagementWidget::removeGroup, this, num));
+    row.row->elementAt(4)->addWidget(removeGroupButton);
+
+    groupRows_[num] = row;
+}
 
-        //transition definer
-        WLineEdit *editGroupTransition = new WLineEdit();
-        editGroupTransition->resize(40,20);
-        //display transition time to user in seconds (transition time is stored as multiple of 100ms)
-        editGroupTransition->setValueText(boost::lexical_cast<string>(group->getTransition()));
-        tableRow->elementAt(3)->addWidget(editGroupTransition);
-        intValidator = new WIntValidator(0, 100, tableRow->elementAt(2)); //100 second maximum
-        intValidator->setMandatory(true);
-        editGroupTransition->setValidator(intValidator);
-        editGroupTransition->changed().connect(bind([=] {
-            group->setTransition(boost::lexical_cast<int>(editGroupTransition->valueText()));
-        }));
-        tableRow->elementAt(3)->addWidget(new WText(" seconds"));
-
-        WPushButton *editGroupButton_ = new WPushButton("Edit");
-        editGroupButton_->clicked().connect(boost::bind(&LightManagementWidget::editGroupDialog, this, group));
-        tableRow->elementAt(4)->addWidget(editGroupButton_);
-
-        WPushButton *advancedButton_ = new WPushButton("Advanced");
-        advancedButton_->clicked().connect(boost::bind(&LightManagementWidget::groupAdvancedDialog, this, group));
-        tableRow->elementAt(4)->addWidget(advancedButton_);
-
-        // remove group
-        WPushButton *removeGroupButton = new WPushButton("Remove");
-        removeGroupButton->clicked().connect(boost::bind(&LightManagementWidget::removeGroup, this, group));
-        tableRow->elementAt(4)->addWidget(removeGroupButton);
+/**
+ *   @brief  Update group row function, changes only the cells of an existing row whose
+ *           values differ from the group.
+ *
+ *   @param  row is the row showing the group
+ *   @param  group is the current group object
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::updateGroupRow(GroupRow &row, Group *group) {
+    if(row.name->text() != group->getName())
+        row.name->setText(group->getName());
+
+    const vector<uint16_t> &lights = group->getLights();
+    if(row.lights != lights) {
+        row.row->elementAt(2)->clear();
+        for(int lightNum : lights) {
+            row.row->elementAt(2)->addWidget(new WText(boost::lexical_cast<string>(lightNum)));
+            row.row->elementAt(2)->addWidget(new WBreak());
+        }
+        row.lights = lights;
     }
 }
 
+/**
+ *   @brief  Group transition function, reads the transition time entered in a group's row.
+ *           The transition is only kept in the page, the shared bridge state is not changed.
+ *
+ *   @param  num is the number of the group
+ *
+ *   @return  int the transition time, 4 if the row has no valid value
+ *
+ */
+int LightManagementWidget::groupTransition(int num) {
+    auto row = groupRows_.find(num);
+    if(row == groupRows_.end() || row->second.transition->validate() != WValidator::Valid)
+        return 4;
+    return boost::lexical_cast<int>(row->second.transition->valueText());
+}
+
 /**
  *   @brief  Create groups function, when the create button is clicked, a dialog appears where the user
  *           can create a group and select lights to be added to the group.
@@ -802,14 +1063,9 @@ void LightManagementWidget::createGroupDialog() {
     new WBreak(createGroupDialog_->contents());
 
     new WLabel("Lights: ", createGroupDialog_->contents());
-    Json::Object bridgeJson;
-    Json::parse(bridge_->getJson(), bridgeJson);
-    Json::Object lights = bridgeJson.get("lights");
-
-    set<string> data = lights.names();
     lightBoxes.clear(); //empty lightbox
-    for(string num : data) {
-        WCheckBox *lightButton_ = new WCheckBox(num, createGroupDialog_->contents());
+    for(auto &entry : bridge_->getState()->getLights()) {
+        WCheckBox *lightButton_ = new WCheckBox(entry.second.getLightnum(), createGroupDialog_->contents());
         lightBoxes.push_back(lightButton_);
     }
     new WBreak(createGroupDialog_->contents());
@@ -822,6 +1078,7 @@ void LightManagementWidget::createGroupDialog() {
     cancel->clicked().connect(createGroupDialog_, &WDialog::reject);
 
     createGroupDialog_->finished().connect(boost::bind(&LightManagementWidget::createGroup, this));
+    createGroupDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, createGroupDialog_));
 
     createGroupDialog_->show();
 }
@@ -864,12 +1121,15 @@ void LightManagementWidget::createGroup(){
  *   @brief  Remove group function, creates a JSON request to remove the selected group
  *           from the current bridge.
  *
- *   @param  group is the group object to remove from the bridge.
+ *   @param  num is the number of the group to remove from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::removeGroup(Group *group) {
+void LightManagementWidget::removeGroup(int num) {
+    Group *group = bridge_->getState()->getGroup(num);
+    if(!group) return;
+
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/groups/" + group->getGroupnum().toUTF8();
     deleteRequest(url);
 }
@@ -878,12 +1138,15 @@ void LightManagementWidget::removeGroup(Group *group) {
  *   @brief  Edit group function, when the edit button is clicked, a window where the user can
  *           change lights assigned to the selected group appears.
  *
- *   @param  group is the group object that was selected to edit from the table.
+ *   @param  num is the number of the group that was selected to edit from the table.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::editGroupDialog(Group *group) {
+void LightManagementWidget::editGroupDialog(int num) {
+    Group *group = bridge_->getState()->getGroup(num);
+    if(!group) return;
+
     editGroupDialog_ = new WDialog("Edit Group #" + group->getGroupnum().toUTF8()); // title
 
     new WLabel("Group Name: ", editGroupDialog_->contents());
@@ -892,14 +1155,9 @@ void LightManagementWidget::editGroupDialog(Group *group) {
     new WBreak(editGroupDialog_->contents());
 
     new WLabel("Lights: ", editGroupDialog_->contents());
-    Json::Object bridgeJson;
-    Json::parse(bridge_->getJson(), bridgeJson);
-    Json::Object lights = bridgeJson.get("lights");
-
-    set<string> data = lights.names();
     lightBoxes.clear(); //empty lightbox
-    for(string num : data) {
-        WCheckBox *lightButton_ = new WCheckBox(num, editGroupDialog_->contents());
+    for(auto &entry : bridge_->getState()->getLights()) {
+        WCheckBox *lightButton_ = new WCheckBox(entry.second.getLightnum(), editGroupDialog_->contents());
         lightBoxes.push_back(lightButton_);
     }
     new WBreak(editGroupDialog_->contents());
@@ -911,7 +1169,8 @@ void LightManagementWidget::editGroupDialog(Group *group) {
     ok->clicked().connect(editGroupDialog_, &WDialog::accept);
     cancel->clicked().connect(editGroupDialog_, &WDialog::reject);
 
-    editGroupDialog_->finished().connect(boost::bind(&LightManagementWidget::updateGroupInfo, this, group));
+    editGroupDialog_->finished().connect(boost::bind(&LightManagementWidget::updateGroupInfo, this, num));
+    editGroupDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, editGroupDialog_));
 
     editGroupDialog_->show();
 }
@@ -921,12 +1180,15 @@ void LightManagementWidget::editGroupDialog(Group *group) {
  *   @brief  Update groups function, creates a JSON request to change properties of
  *           a given group based on user's inputs in the edit group dialog box.
  *
- *   @param  group is the group object to update from the bridge.
+ *   @param  num is the number of the group to update from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::updateGroupInfo(Group *group){
+void LightManagementWidget::updateGroupInfo(int num){
+    Group *group = bridge_->getState()->getGroup(num);
+    if(!group) return;
+
     if (editGroupDialog_->result() == WDialog::DialogCode::Rejected)
         return;
 
@@ -959,16 +1221,19 @@ void LightManagementWidget::updateGroupInfo(Group *group){
  *   @brief  Update groups advanced function, creates a opens a dialog box to change
  *           any property of a given group based on user's inputs in the dialog box.
  *
- *   @param  group is the group object to update from the bridge.
+ *   @param  num is the number of the group to update from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::groupAdvancedDialog(Group *group) {
+void LightManagementWidget::groupAdvancedDialog(int num) {
+    Group *group = bridge_->getState()->getGroup(num);
+    if(!group) return;
+
     groupAdvancedDialog_ = new WDialog("Advanced"); // title
 
     new WLabel("State: ", groupAdvancedDialog_->contents());
-    onButtonGroup = new WButtonGroup(this);
+    onButtonGroup = new WButtonGroup(groupAdvancedDialog_); //freed with the dialog
     WRadioButton *onRadioButton;
     onRadioButton = new WRadioButton("On", groupAdvancedDialog_->contents());
     onButtonGroup->addButton(onRadioButton, 0);
@@ -996,9 +1261,9 @@ void LightManagementWidget::groupAdvancedDialog(Group *group) {
     redSlider->setDisabled(false);
     greenSlider->setDisabled(false);
     blueSlider->setDisabled(false);
-    WCssDecorationStyle *colour = new WCssDecorationStyle();
-    colour->setBackgroundColor(WColor(redSlider->value(), greenSlider->value(), blueSlider->value()));
-    rgbContainer_->setDecorationStyle(*colour);
+    //the lights of a group can differ in gamut, each one is clamped by the bridge
+    previewGamut_ = &ColourConvert::GAMUT_DEFAULT;
+    showRGBPreview();
     new WBreak(groupAdvancedDialog_->contents());
 
     // disable all fields while group is off
@@ -1018,7 +1283,8 @@ void LightManagementWidget::groupAdvancedDialog(Group *group) {
     cancel->clicked().connect(groupAdvancedDialog_, &WDialog::reject);
 
     // when the user is finished, call function to update group
-    groupAdvancedDialog_->finished().connect(boost::bind(&LightManagementWidget::groupUpdateAdvanced, this, group));
+    groupAdvancedDialog_->finished().connect(boost::bind(&LightManagementWidget::groupUpdateAdvanced, this, num));
+    groupAdvancedDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, groupAdvancedDialog_));
     groupAdvancedDialog_->show();
 }
 
@@ -1026,12 +1292,15 @@ void LightManagementWidget::groupAdvancedDialog(Group *group) {
  *   @brief  Update groups function, creates a JSON request to change properties of
  *           a given group based on user's inputs in the advanced group dialog box.
  *
- *   @param  light is the light object to update from the bridge.
+ *   @param  num is the number of the group to update from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::groupUpdateAdvanced(Group *group){
+void LightManagementWidget::groupUpdateAdvanced(int num){
+    Group *group = bridge_->getState()->getGroup(num);
+    if(!group) return;
+
     if (groupAdvancedDialog_->result() == WDialog::DialogCode::Rejected)
         return;
 
@@ -1052,11 +1321,11 @@ void LightManagementWidget::groupUpdateAdvanced(Group *group){
 
     //sets new xval and yval if the sliders have been changed from default values
     if(redSlider->value() != 1 || greenSlider->value() != 2 || blueSlider->value() != 3) {
-        struct xy *cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value());
+        struct xy cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value());
 
-        xval = boost::lexical_cast<string>(cols->x);
-        yval = boost::lexical_cast<string>(cols->y);
-        bri = boost::lexical_cast<string>((int)(cols->brightness));
+        xval = boost::lexical_cast<string>(cols.x);
+        yval = boost::lexical_cast<string>(cols.y);
+        bri = boost::lexical_cast<string>((int)(cols.brightness));
     }
 
     //json formatting
@@ -1072,78 +1341,169 @@ void LightManagementWidget::groupUpdateAdvanced(Group *group){
         actionJSON["xy"] = Json::Value(xyJSON);
     }
 
-    if(group->getTransition() != 4 && on != "0") actionJSON["transitiontime"] = Json::Value(group->getTransition());
+    int transition = groupTransition(num);
+    if(transition != 4 && on != "0") actionJSON["transitiontime"] = Json::Value(transition);
 
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/groups/" + group->getGroupnum().toUTF8() + "/action";
     putRequest(url, Json::serialize(actionJSON));
 }
 
 /**
- *   @brief  Update schedules table function, clears the current table and re-populates it with
- *           all the schedules that are in the bridge.
+ *   @brief  Update schedules table function, brings the table in line with the schedules that
+ *           are in the bridge. Only rows of added or removed schedules are created or deleted and
+ *           only cells whose values changed are touched.
  *
  *   @return  void
  *
  */
 void LightManagementWidget::updateSchedulesTable() {
-    schedulesTable_->clear();
+    if(!schedulesTable_ || !bridge_->getState()->isLoaded(BridgeState::Schedules)) return;
+    map<int, Schedule> &schedules = bridge_->getState()->getSchedules();
+
+    // create row for headers table the first time the table is filled
+    if(schedulesTable_->rowCount() == 0) {
+        WTableRow *tableRow = schedulesTable_->insertRow(0);
+        //table headers <th>
+        tableRow->elementAt(0)->addWidget(new WText("Name"));
+        tableRow->elementAt(1)->addWidget(new WText("Description"));
+        tableRow->elementAt(2)->addWidget(new WText("Action"));
+        tableRow->elementAt(3)->addWidget(new WText("Time"));
+    }
 
-    // create row for headers table
-    WTableRow *tableRow = schedulesTable_->insertRow(schedulesTable_->rowCount());
-    //table headers <th>
-    tableRow->elementAt(0)->addWidget(new WText("Name"));
-    tableRow->elementAt(1)->addWidget(new WText("Description"));
-    tableRow->elementAt(2)->addWidget(new WText("Action"));
-    tableRow->elementAt(3)->addWidget(new WText("Time"));
+    //remove rows of schedules that are no longer on the bridge
+    for(auto it = scheduleRows_.begin(); it != scheduleRows_.end();) {
+        if(schedules.count(it->first) == 0) {
+            schedulesTable_->deleteRow(it->second.row->rowNum());
+            it = scheduleRows_.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
 
-    //convert json string into json object
-    Json::Object bridgeJson;
-    Json::parse(bridge_->getJson(), bridgeJson);
-    Json::Object schedules = bridgeJson.get("schedules");
+    //schedules and rows are both ordered by schedule number, so new rows are inserted in place
+    int index = 1;
+    for(auto &entry : schedules) {
+        auto row = scheduleRows_.find(entry.first);
+        if(row == scheduleRows_.end()) {
+            insertScheduleRow(entry.first, &entry.second, index);
+        }
+        else {
+            updateScheduleRow(row->second, &entry.second);
+        }
+        index++;
+    }
+}
 
-    set<string> data = schedules.names();
-    for(string num : data) {
-        Json::Object scheduleData = schedules.get(num);
-        Schedule *schedule = new Schedule(num, scheduleData);
+/**
+ *   @brief  Schedule action function, builds the lines shown in the action cell of a schedule.
+ *
+ *   @param  schedule is the schedule object to describe
+ *
+ *   @return  vector<string> the lines of the action cell
+ *
+ */
+vector<string> LightManagementWidget::scheduleAction(Schedule *schedule) {
+    vector<string> action;
+    action.push_back(schedule->getMethod().toUTF8());
+    action.push_back(schedule->getAddress().toUTF8());
 
-        tableRow = schedulesTable_->insertRow(schedulesTable_->rowCount());
+    if(schedule->getMethod().toUTF8() != "DELETE") {
+        string onState = schedule->getOn() == 1 ? "true" : "false";
+        action.push_back("On: " + onState);
 
-        tableRow->elementAt(0)->addWidget(new WText(schedule->getName()));
-        tableRow->elementAt(1)->addWidget(new WText(schedule->getDescription()));
+        if(schedule->getX() != -1 && schedule->getY() != -1) {
+            action.push_back("Color: [" + boost::lexical_cast<string>(schedule->getX()) + "," + boost::lexical_cast<string>(schedule->getY()) + "]");
+        }
+        if(schedule->getBri() != -1) {
+            action.push_back("Bri: " + boost::lexical_cast<string>(schedule->getBri()));
+        }
+        if(schedule->getTransition() != 4) {
+            action.push_back("Transition: " + boost::lexical_cast<string>(schedule->getTransition()));
+        }
+    }
+    return action;
+}
 
-        tableRow->elementAt(2)->addWidget(new WText(schedule->getMethod().toUTF8()));
-        tableRow->elementAt(2)->addWidget(new WBreak());
+/**
+ *   @brief  Show schedule action function, fills the action cell of a schedule row.
+ *
+ *   @param  row is the row showing the schedule
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::showScheduleAction(ScheduleRow &row) {
+    WTableCell *cell = row.row->elementAt(2);
+    cell->clear();
+    for(unsigned int i = 0; i < row.action.size(); i++) {
+        cell->addWidget(new WText(row.action[i]));
+        if(i + 1 < row.action.size()) cell->addWidget(new WBreak());
+    }
+}
 
-        tableRow->elementAt(2)->addWidget(new WText(schedule->getAddress().toUTF8()));
-        tableRow->elementAt(2)->addWidget(new WBreak());
+/**
+ *   @brief  Insert schedule row function, creates the row for a schedule at the given index of
+ *           the schedules table.
+ *
+ *   @param  num is the schedule number
+ *   @param  schedule is the schedule object to show in the row
+ *   @param  index is the table row to insert at
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::insertScheduleRow(int num, Schedule *schedule, int index) {
+    ScheduleRow row;
 
-        if(schedule->getMethod().toUTF8() != "DELETE") {
-            string onState = schedule->getOn() == 1 ? "true" : "false";
-            tableRow->elementAt(2)->addWidget(new WText("On: " + onState));
-            tableRow->elementAt(2)->addWidget(new WBreak());
+    row.row = schedulesTable_->insertRow(index);
 
-            if(schedule->getX() != -1 && schedule->getY() != -1) {
-                tableRow->elementAt(2)->addWidget(new WText("Color: [" + boost::lexical_cast<string>(schedule->getX()) + "," + boost::lexical_cast<string>(schedule->getY()) + "]"));
-                tableRow->elementAt(2)->addWidget(new WBreak());
-            }
-            if(schedule->getBri() != -1) {
-                tableRow->elementAt(2)->addWidget(new WText("Bri: " + boost::lexical_cast<string>(schedule->getBri())));
-                tableRow->elementAt(2)->addWidget(new WBreak());
-            }
-            if(schedule->getTransition() != 4) {
-                tableRow->elementAt(2)->addWidget(new WText("Transition: " + boost::lexical_cast<string>(schedule->getTransition())));
-            }
-        }
+    row.name = new WText(schedule->getName());
+    row.row->elementAt(0)->addWidget(row.name);
+    row.description = new WText(schedule->getDescription());
+    row.row->elementAt(1)->addWidget(row.description);
+
+    row.action = scheduleAction(schedule);
+    showScheduleAction(row);
+
+    row.time = new WText(schedule->getTime());
+    row.row->elementAt(3)->addWidget(row.time);
+
+    WPushButton *editScheduleButton = new WPushButton("Edit");
+    editScheduleButton->clicked().connect(boost::bind(&LightManagementWidget::editScheduleDialog, this, num));
+    row.row->elementAt(4)->addWidget(editScheduleButton);
+
+    WPushButton *removeScheduleButton = new WPushButton("Remove");
+    removeScheduleButton->clicked().connect(boost::bind(&LightManagementWidget::removeSchedule, this, num));
+    row.row->elementAt(4)->addWidget(removeScheduleButton);
+
+    scheduleRows_[num] = row;
+}
+
+/**
+ *   @brief  Update schedule row function, changes only the cells of an existing row whose
+ *           values differ from the schedule.
+ *
+ *   @param  row is the row showing the schedule
+ *   @param  schedule is the current schedule object
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::updateScheduleRow(ScheduleRow &row, Schedule *schedule) {
+    if(row.name->text() != schedule->getName())
+        row.name->setText(schedule->getName());
 
-        tableRow->elementAt(3)->addWidget(new WText(schedule->getTime()));
+    if(row.description->text() != schedule->getDescription())
+        row.description->setText(schedule->getDescription());
 
-        WPushButton *editScheduleButton = new WPushButton("Edit");
-        editScheduleButton->clicked().connect(boost::bind(&LightManagementWidget::editScheduleDialog, this, schedule));
-        tableRow->elementAt(4)->addWidget(editScheduleButton);
+    if(row.time->text() != schedule->getTime())
+        row.time->setText(schedule->getTime());
 
-        WPushButton *removeScheduleButton = new WPushButton("Remove");
-        removeScheduleButton->clicked().connect(boost::bind(&LightManagementWidget::removeSchedule, this, schedule));
-        tableRow->elementAt(4)->addWidget(removeScheduleButton);
+    vector<string> action = scheduleAction(schedule);
+    if(row.action != action) {
+        row.action = action;
+        showScheduleAction(row);
     }
 }
 
@@ -1235,9 +1595,9 @@ void LightManagementWidget::createScheduleDialog() {
     redSlider->setDisabled(false);
     greenSlider->setDisabled(false);
     blueSlider->setDisabled(false);
-    WCssDecorationStyle *colour = new WCssDecorationStyle();
-    colour->setBackgroundColor(WColor(redSlider->value(), greenSlider->value(), blueSlider->value()));
-    rgbContainer_->setDecorationStyle(*colour);
+    //the lights of a group can differ in gamut, each one is clamped by the bridge
+    previewGamut_ = &ColourConvert::GAMUT_DEFAULT;
+    showRGBPreview();
     new WBreak(bodyGroupContainer);
     // transition time
     new WLabel("Transition time: ", bodyGroupContainer);
@@ -1267,6 +1627,7 @@ void LightManagementWidget::createScheduleDialog() {
 
     // when the user is finished, call the ADD SCHEDULE function
     createScheduleDialog_->finished().connect(boost::bind(&LightManagementWidget::createSchedule, this));
+    createScheduleDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, createScheduleDialog_));
     createScheduleDialog_->show();
 }
 
@@ -1330,11 +1691,11 @@ void LightManagementWidget::createSchedule() {
 
     //sets new xval and yval if the sliders have been changed from default values
     if(redSlider->value() != 1 || greenSlider->value() != 2 || blueSlider->value() != 3) {
-        struct xy *cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value());
+        struct xy cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value());
 
-        xval = boost::lexical_cast<string>(cols->x);
-        yval = boost::lexical_cast<string>(cols->y);
-        bri = boost::lexical_cast<string>((int)(cols->brightness));
+        xval = boost::lexical_cast<string>(cols.x);
+        yval = boost::lexical_cast<string>(cols.y);
+        bri = boost::lexical_cast<string>((int)(cols.brightness));
     }
 
     //if value is 4 user did not change it
@@ -1376,12 +1737,15 @@ void LightManagementWidget::createSchedule() {
  *   @brief  Edit schedule function, when the edit button is clicked, a window where the user can
  *           change properties for the selected schedule appears.
  *
- *   @param  schedule is the schedule object that was selected to edit from the table.
+ *   @param  num is the number of the schedule that was selected to edit from the table.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::editScheduleDialog(Schedule *schedule) {
+void LightManagementWidget::editScheduleDialog(int num) {
+    Schedule *schedule = bridge_->getState()->getSchedule(num);
+    if(!schedule) return;
+
     editScheduleDialog_ = new WDialog("Edit Schedule #" + schedule->getSchedulenum().toUTF8());
 
     new WLabel("Schedule Name: ", editScheduleDialog_->contents());
@@ -1462,9 +1826,9 @@ void LightManagementWidget::editScheduleDialog(Schedule *schedule) {
     redSlider->setDisabled(false);
     greenSlider->setDisabled(false);
     blueSlider->setDisabled(false);
-    WCssDecorationStyle *colour = new WCssDecorationStyle();
-    colour->setBackgroundColor(WColor(redSlider->value(), greenSlider->value(), blueSlider->value()));
-    rgbContainer_->setDecorationStyle(*colour);
+    //the lights of a group can differ in gamut, each one is clamped by the bridge
+    previewGamut_ = &ColourConvert::GAMUT_DEFAULT;
+    showRGBPreview();
     new WBreak(bodyGroupContainer);
     // transition time
     new WLabel("Transition time: ", bodyGroupContainer);
@@ -1492,7 +1856,8 @@ void LightManagementWidget::editScheduleDialog(Schedule *schedule) {
     ok->clicked().connect(editScheduleDialog_, &WDialog::accept);
     cancel->clicked().connect(editScheduleDialog_, &WDialog::reject);
 
-    editScheduleDialog_->finished().connect(boost::bind(&LightManagementWidget::updateScheduleInfo, this, schedule));
+    editScheduleDialog_->finished().connect(boost::bind(&LightManagementWidget::updateScheduleInfo, this, num));
+    editScheduleDialog_->finished().connect(boost::bind(&LightManagementWidget::closeDialog, this, editScheduleDialog_));
 
     editScheduleDialog_->show();
 }
@@ -1501,12 +1866,15 @@ void LightManagementWidget::editScheduleDialog(Schedule *schedule) {
  *   @brief  Update schedule function, creates a JSON request to change properties of
  *           a given schedule based on user's inputs in the edit schedule dialog box.
  *
- *   @param  schedule is the schedule object to update from the bridge.
+ *   @param  num is the number of the schedule to update from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::updateScheduleInfo(Schedule *schedule){
+void LightManagementWidget::updateScheduleInfo(int num){
+    Schedule *schedule = bridge_->getState()->getSchedule(num);
+    if(!schedule) return;
+
     if (editScheduleDialog_->result() == WDialog::DialogCode::Rejected)
         return;
     if (resourceNum->validate() != 2)
@@ -1533,7 +1901,7 @@ void LightManagementWidget::updateScheduleInfo(Schedule *schedule){
         resource = "/groups";
         resourceTwo = "/action";
     }
-    string num = "/" + resourceNum->valueText().toUTF8();
+    string target = "/" + resourceNum->valueText().toUTF8();
 
     if(actionButtonGroup->checkedButton()->text() == "Change") {
         action = "PUT";
@@ -1541,7 +1909,7 @@ void LightManagementWidget::updateScheduleInfo(Schedule *schedule){
     else if(actionButtonGroup->checkedButton()->text() == "Add") {
         action = "POST";
         resourceTwo = "";
-        num = "";
+        target = "";
     }
     else {
         action = "DELETE";
@@ -1559,11 +1927,11 @@ void LightManagementWidget::updateScheduleInfo(Schedule *schedule){
 
     //sets new xval and yval if the sliders have been changed from default values
     if(redSlider->value() != 1 || greenSlider->value() != 2 || blueSlider->value() != 3) {
-        struct xy *cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value());
+        struct xy cols = ColourConvert::rgb2xy(redSlider->value(), greenSlider->value(), blueSlider->value());
 
-        xval = boost::lexical_cast<string>(cols->x);
-        yval = boost::lexical_cast<string>(cols->y);
-        bri = boost::lexical_cast<string>((int)(cols->brightness));
+        xval = boost::lexical_cast<string>(cols.x);
+        yval = boost::lexical_cast<string>(cols.y);
+        bri = boost::lexical_cast<string>((int)(cols.brightness));
     }
 
     //if value is 4 user did not change it
@@ -1575,7 +1943,7 @@ void LightManagementWidget::updateScheduleInfo(Schedule *schedule){
     if(desc != "") scheduleJSON["description"] = Json::Value(desc);
 
     Json::Object commandJSON;
-    commandJSON["address"] = Json::Value("/api/" + bridge_->getUsername() + resource + num + resourceTwo);
+    commandJSON["address"] = Json::Value("/api/" + bridge_->getUsername() + resource + target + resourceTwo);
     commandJSON["method"] = Json::Value(action);
     commandJSON["body"] = Json::Value(Json::ObjectType);
 
@@ -1607,18 +1975,21 @@ void LightManagementWidget::updateScheduleInfo(Schedule *schedule){
  *   @brief  Remove schedule function, creates a JSON request to remove the selected
  *           schedule from the current bridge.
  *
- *   @param  schedule is the schedule object to remove from the bridge.
+ *   @param  num is the number of the schedule to remove from the bridge.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::removeSchedule(Schedule *schedule) {
+void LightManagementWidget::removeSchedule(int num) {
+    Schedule *schedule = bridge_->getState()->getSchedule(num);
+    if(!schedule) return;
+
     string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() + "/schedules/" + schedule->getSchedulenum().toUTF8();
     deleteRequest(url);
 }
 
 /**
- *   @brief  Function that creates a new HTTP Client and generates a Client DELETE request to access the Hue API for the current resource specified in URL. Calls handlePutHttp() function once client is done the DELETE call to handle the response.
+ *   @brief  Function that queues a DELETE request on the bridge client to access the Hue API for the current resource specified in URL. Calls handlePutHttp() function once the DELETE call is done to handle the response.
  *
  *   @param  url the url of the resource to DELETE
  *
@@ -1626,24 +1997,12 @@ void LightManagementWidget::removeSchedule(Schedule *schedule) {
  *
  */
 void LightManagementWidget::deleteRequest(string url) {
-    Http::Message *data = new Http::Message();
-
-    cout << "DELETE: Deleting at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
-
-    if(client->deleteRequest(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "DELETE: Error in client->deleteRequest() call\n";
-    }
+    commandSent();
+    client_->deleteRequest(url, this, boost::bind(&LightManagementWidget::handlePutHttp, this, url, string(""), _1, _2));
 }
 
 /**
- *   @brief  Function that creates a new HTTP Client and generates a Client PUT request to access the Hue API for the current resource specified in URL. Calls handlePutHttp() function once client is done the PUT call to handle the response.
+ *   @brief  Function that queues a PUT request on the bridge client to access the Hue API for the current resource specified in URL. Calls handlePutHttp() function once the PUT call is done to handle the response.
  *
  *   @param  url the url of the resource to PUT the json data to
  *   @param  json the body json data to PUT to the Hue API
@@ -1652,25 +2011,28 @@ void LightManagementWidget::deleteRequest(string url) {
  *
  */
 void LightManagementWidget::putRequest(string url, string json){
-    Http::Message *data = new Http::Message();
-    data->addBodyText(json);
-
-    cout << "PUT: Updating at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
+    commandSent();
+    client_->put(url, json, this, boost::bind(&LightManagementWidget::handlePutHttp, this, url, json, _1, _2));
+}
 
-    if(client->put(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "Light: Error in client->put(url) call\n";
-    }
+/**
+ *   @brief  Function that queues a PUT of light state attributes on the bridge client. Commands to the same light are
+ *           coalesced while one is in flight, so only the newest value of each attribute is sent. Calls handlePutHttp()
+ *           function once the PUT call is done to handle the response.
+ *
+ *   @param  url the url of the light state to PUT the attributes to
+ *   @param  state the attributes to set on the light
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::putLightState(string url, const Json::Object &state) {
+    commandSent();
+    client_->putLatest(url, state, this, boost::bind(&LightManagementWidget::handlePutHttp, this, url, Json::serialize(state), _1, _2));
 }
 
 /**
- *   @brief  Function that creates a new HTTP Client and generates a Client POST request to access the Hue API for the current resource specified in URL. Calls handlePutHttp() function once client is done the POST call to handle the response.
+ *   @brief  Function that queues a POST request on the bridge client to access the Hue API for the current resource specified in URL. Calls handlePutHttp() function once the POST call is done to handle the response.
  *
  *   @param  url the url of the resource to POST the json data to
  *   @param  json the body json data to POST to the Hue API
@@ -1679,87 +2041,305 @@ void LightManagementWidget::putRequest(string url, string json){
  *
  */
 void LightManagementWidget::postRequest(string url, string json) {
-    Http::Message *data = new Http::Message();
-    data->addBodyText(json);
-
-    cout << "POST: Updating at URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::handlePutHttp, this, _1, _2));
-
-    if(client->post(url, *data)) {
-        WApplication::instance()->deferRendering();
-    }
-    else {
-        cerr << "POST: Error in client->post() call\n";
-    }
+    commandSent();
+    client_->post(url, json, this, boost::bind(&LightManagementWidget::handlePutHttp, this, url, json, _1, _2));
 }
 
 /**
  *   @brief  Function to handle the Http response generated by the Wt Http Client object. This function handles the done() signal sent when doing Client's put, post, and deleteRequest functions even though it is named handlePutHttp.
+ *           The success results of the Hue API are folded into the stored bridge state, the bridge is only
+ *           fetched again if the response could not be applied.
  *
+ *   @param  url the url of the resource that was changed
+ *   @param  json the body json data that was sent to the Hue API
  *   @param  *err stores the error code generated by an Http request, null if request was successful
  *   @param  &response stores the response message generated by the Http request
  *
  *   @return  void
  *
  */
-void LightManagementWidget::handlePutHttp(boost::system::error_code err, const Wt::Http::Message &response){
-    WApplication::instance()->resumeRendering();
+void LightManagementWidget::handlePutHttp(string url, string json, boost::system::error_code err, const Wt::Http::Message &response){
+    pending_--;
     if (!err && response.status() == 200) {
         cout << "Successful update" << "\n";
-        refreshBridge();
+        string bridgeUrl = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername();
+        string resource = url.substr(min(bridgeUrl.size(), url.size()));
+
+        //the change is applied to a copy of the shared state, which the other sessions then receive
+        shared_ptr<BridgeState> state = BridgeRegistry::instance()->applyResponse(bridge_->getKey(), subscription_, resource, json, response.body());
+        if(state) {
+            bridge_->setState(state);
+            updateLightsTable();
+            updateGroupsTable();
+            updateSchedulesTable();
+        }
+        else {
+            refreshBridge();
+        }
+        statusText_->setText("");
     }
     else {
         cerr << "Error: " << err.message() << ", " << response.status() << "\n";
+        //stored state is unchanged, so this puts back any control changed ahead of the response
+        updateLightsTable();
+        updateGroupsTable();
+        updateSchedulesTable();
+        statusText_->setText("The bridge did not accept the last command.");
     }
+    showPending();
+    WApplication::instance()->triggerUpdate();
 }
 
 /**
- *   @brief  Function that creates a new HTTP Client and generates a Client GET request to access the Hue API for the current Bridge. Calls refreshBridgeHttp() function once client is done the GET call to handle the response.
+ *   @brief  Show RGB preview function, colours the RGB picker with the slider colour moved into
+ *           the gamut of the light being edited so the preview matches what the light will show.
+ *           Called when the picker is shown, the browser follows the sliders after that.
  *
  *   @return  void
  *
  */
-void LightManagementWidget::refreshBridge() {
-    string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername();
+void LightManagementWidget::showRGBPreview() {
+    float red = redSlider->value(), green = greenSlider->value(), blue = blueSlider->value();
+    struct xy requested = ColourConvert::rgb2xy(red, green, blue);
+    struct xy shown = ColourConvert::clampToGamut(requested, *previewGamut_);
+
+    if (shown.x != requested.x || shown.y != requested.y) {
+        // keep the brightest channel of the slider colour so only the hue changes
+        struct rgb clamped = ColourConvert::xy2rgb(shown.x, shown.y, shown.brightness);
+        float peak = max(clamped.r, max(clamped.g, clamped.b));
+        float scale = peak > 0 ? max(red, max(green, blue)) / peak : 0;
+        red = min(clamped.r * scale, 255.0f);
+        green = min(clamped.g * scale, 255.0f);
+        blue = min(clamped.b * scale, 255.0f);
+    }
+    rgbContainer_->decorationStyle().setBackgroundColor(WColor((int)red, (int)green, (int)blue));
+
+    //the browser clamps the preview to the same gamut while the sliders move
+    const struct gamut &corners = *previewGamut_;
+    string gamutCorners;
+    for(float corner : {corners.red[0], corners.red[1], corners.green[0], corners.green[1], corners.blue[0], corners.blue[1]}) {
+        if(!gamutCorners.empty()) gamutCorners += ",";
+        gamutCorners += boost::lexical_cast<string>(corner);
+    }
+    rgbContainer_->setAttributeValue("data-gamut", gamutCorners);
+}
 
-    cout << "BRIDGE: Connecting to URL " << url << "\n";
-    Wt::Http::Client *client = new Wt::Http::Client(this);
-    client->setTimeout(2); //2 second timeout of request
-    client->setMaximumResponseSize(1000000);
-    client->done().connect(boost::bind(&LightManagementWidget::refreshBridgeHttp, this, _1, _2));
+/**
+ *   @brief  Show hue/sat preview function, colours the hue/saturation picker with the colour of
+ *           its sliders when it is shown, the browser follows the sliders after that
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::showHueSatPreview() {
+    struct rgb hsRgb = ColourConvert::hsv2rgb((float)hueSlider->value(), (float)satSlider->value(),
+                                              (float)briSlider->value());
+    hueSatContainer_->decorationStyle().setBackgroundColor(WColor((int)hsRgb.r, (int)hsRgb.g, (int)hsRgb.b));
+}
+
+/**
+ *   @brief  Show CT preview function, colours the colour temperature picker from the table of
+ *           white points when it is shown, the browser follows the sliders after that
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::showCtPreview() {
+    struct rgb white = ColourConvert::ct2rgb(ctSlider->value(), ctBriSlider->value());
+    ctContainer_->decorationStyle().setBackgroundColor(WColor((int)white.r, (int)white.g, (int)white.b));
+}
 
-    if(client->get(url)) {
-        WApplication::instance()->deferRendering();
+/**
+ *   @brief  Close dialog function, deletes a dialog once its finished handler has run. The colour
+ *           pickers are taken out first since they are kept and shown again by the next dialog.
+ *
+ *   @param  *dialog is the dialog that finished
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::closeDialog(WDialog *dialog) {
+    if(rgbContainer_ && rgbContainer_->parent() == dialog->contents()) {
+        dialog->contents()->removeWidget(rgbContainer_);
     }
-    else {
-        cerr << "BRIDGE: Error in client->get(url) call\n";
+    if(hueSatContainer_ && hueSatContainer_->parent() == dialog->contents()) {
+        dialog->contents()->removeWidget(hueSatContainer_);
+    }
+    if(ctContainer_ && ctContainer_->parent() == dialog->contents()) {
+        dialog->contents()->removeWidget(ctContainer_);
     }
+    delete dialog;
+}
+
+/**
+ *   @brief  Command sent function, counts a command sent to the bridge and shows the pending indicator
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::commandSent() {
+    pending_++;
+    showPending();
+    //someone is using the bridge, poll it quickly so the other sessions follow along
+    BridgeRegistry::instance()->touch(bridge_->getKey());
 }
 
 /**
- *   @brief  Function to handle the Http response generated by the Wt Http Client object
+ *   @brief  Show pending function, shows how many commands are still waiting for the bridge
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::showPending() {
+    if(pending_ > 0) {
+        pendingText_->setText("Sending " + boost::lexical_cast<string>(pending_) + (pending_ == 1 ? " command..." : " commands..."));
+    }
+    pendingText_->setHidden(pending_ <= 0);
+}
+
+/**
+ *   @brief  Function that fetches the current Bridge again. With live updates on the shared registry
+ *           polls it and delivers the new state to stateChanged() of every session viewing the bridge,
+ *           otherwise this session fetches each resource it has loaded.
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::refreshBridge() {
+    if(subscription_ >= 0) {
+        BridgeRegistry::instance()->refresh(bridge_->getKey());
+        return;
+    }
+
+    for(int i = 0; i < BridgeState::AllResources; i++) {
+        BridgeState::Resource resource = (BridgeState::Resource)i;
+        if(bridge_->getState()->isLoaded(resource)) loadResource(resource, true);
+    }
+}
+
+/**
+ *   @brief  Function that fetches one resource of the Bridge from its own endpoint, e.g. /lights,
+ *           unless it is loaded and still fresh. With live updates on, loaded resources are kept
+ *           fresh by the shared registry.
+ *
+ *   @param  resource is the resource to fetch
+ *   @param  force fetches the resource even if it is fresh
+ *
+ *   @return  void
  *
+ */
+void LightManagementWidget::loadResource(BridgeState::Resource resource, bool force) {
+    BridgeState *state = bridge_->getState();
+    if(loading_[resource]) return;
+    if(!force && state->isLoaded(resource) && (subscription_ >= 0 || state->isFresh(resource, FRESH_PERIOD))) return;
+
+    loading_[resource] = true;
+    string url = "http://" + bridge_->getIP() + ":" + bridge_->getPort() + "/api/" + bridge_->getUsername() +
+                 BridgeState::resourcePath(resource);
+    shared_ptr<BridgeParser> parser = make_shared<BridgeParser>(resource);
+    client_->getStreaming(url, this, boost::bind(&BridgeParser::feed, parser, _1),
+                          boost::bind(&LightManagementWidget::loadResourceHttp, this, parser, _1, _2), BridgeScheduler::Interactive);
+}
+
+/**
+ *   @brief  Function to handle the response of a resource fetched by loadResource(). The resource
+ *           is merged into the shared state, which the other sessions viewing the bridge receive too.
+ *
+ *   @param  parser has read the body of the response
  *   @param  *err stores the error code generated by an Http request, null if request was successful
  *   @param  &response stores the response message generated by the Http request
  *
  *   @return  void
  *
  */
-void LightManagementWidget::refreshBridgeHttp(boost::system::error_code err, const Wt::Http::Message &response){
-    WApplication::instance()->resumeRendering();
-    if (!err && response.status() == 200) {
-        bridge_->setJson(response.body());
+void LightManagementWidget::loadResourceHttp(shared_ptr<BridgeParser> parser, boost::system::error_code err, const Wt::Http::Message &response) {
+    loading_[parser->getResource()] = false;
 
-        //update tables with new JSON information
-        updateLightsTable();
-        updateGroupsTable();
-        updateSchedulesTable();
+    shared_ptr<BridgeState> state;
+    if(!err && response.status() == 200) {
+        state = BridgeRegistry::instance()->setState(bridge_->getIP(), bridge_->getPort(), bridge_->getUsername(), *parser);
+    }
+    if(state) {
+        stateChanged(state);
     }
     else {
         cerr << "Error: " << err.message() << ", " << response.status() << "\n";
+        statusText_->setText("Could not load " + BridgeState::resourcePath(parser->getResource()).substr(1) + " from the bridge.");
+        WApplication::instance()->triggerUpdate();
+    }
+}
+
+/**
+ *   @brief  Function that turns live updates on or off from the live updates check box. While on,
+ *           the shared registry watches the bridge and pushes every change to this session.
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::setLiveUpdates() {
+    if(liveUpdatesBox_->isChecked() && subscription_ < 0) {
+        subscribe();
+    }
+    else if(!liveUpdatesBox_->isChecked() && subscription_ >= 0) {
+        BridgeRegistry::instance()->unsubscribe(subscription_);
+        subscription_ = -1;
+    }
+    refreshButton_->setHidden(subscription_ >= 0);
+}
+
+/**
+ *   @brief  Function that starts watching the bridge in the shared registry. The registry starts
+ *           from the state this session loaded unless another session already watches the bridge,
+ *           in which case its newer state replaces ours.
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::subscribe() {
+    BridgeRegistry *registry = BridgeRegistry::instance();
+    subscription_ = registry->subscribe(bridge_->getIP(), bridge_->getPort(), bridge_->getUsername(),
+                                        WApplication::instance()->sessionId(),
+                                        boost::bind(&LightManagementWidget::stateChanged, this, _1),
+                                        bridge_->getSharedState());
+
+    shared_ptr<BridgeState> polled = registry->getPolled(bridge_->getKey());
+    if(polled && polled != bridge_->getSharedState()) {
+        bridge_->setState(polled);
+        parent_->setBridgeState(bridge_->getKey(), polled);
     }
 }
 
+/**
+ *   @brief  Function that stops watching the bridge once another screen is shown, so the shared
+ *           registry stops polling it for this session. The live updates setting is kept, the
+ *           next light management screen subscribes again when it is created.
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::stopWatching() {
+    if(subscription_ < 0) return;
+    BridgeRegistry::instance()->unsubscribe(subscription_);
+    subscription_ = -1;
+}
+
+/**
+ *   @brief  Function called in this session with every new state of the Bridge from the shared registry
+ *
+ *   @param  state is the new snapshot of the bridge
+ *
+ *   @return  void
+ *
+ */
+void LightManagementWidget::stateChanged(shared_ptr<BridgeState> state) {
+    bridge_->setState(state);
+    //the next light management screen of this bridge starts from the latest state
+    parent_->setBridgeState(bridge_->getKey(), state);
+
+    //update tables with new bridge state
+    updateLightsTable();
+    updateGroupsTable();
+    updateSchedulesTable();
+    WApplication::instance()->triggerUpdate();
+}
+
@@ -0,0 +1,118 @@
+/**
+ *  @file       LoginThrottle.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application login attempt throttle
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class limits how fast logins and sign ups can be tried, so a bot
+ *              guessing emails or passwords is turned away before the account store or the
+ *              password hashing is reached. Every client address and every account has a
+ *              token bucket: an attempt takes a token from both, and tokens come back at a
+ *              fixed rate up to a small burst. The buckets of clients that stopped trying are
+ *              dropped once there are many of them.
+ */
+
+#include <iostream>
+#include "LoginThrottle.h"
+
+/**
+ *   @brief  Returns the throttle shared by every session of the process
+ *
+ *   @return  LoginThrottle* the throttle
+ */
+LoginThrottle *LoginThrottle::instance() {
+    static LoginThrottle throttle;
+    return &throttle;
+}
+
+/**
+ *   @brief  LoginThrottle constructor
+ *
+ */
+LoginThrottle::LoginThrottle() {
+}
+
+/**
+ *   @brief  Charge an attempt against a client address and an account
+ *
+ *   @param  &address is the address of the client
+ *   @param  &account is the email tried, empty for attempts that are not on one account
+ *
+ *   @return  bool false if either is out of attempts, nothing is charged then
+ */
+bool LoginThrottle::allow(const string &address, const string &account) {
+    lock_guard<mutex> lock(mutex_);
+    Clock::time_point now = Clock::now();
+
+    if((int)addresses_.size() > BUCKET_LIMIT) prune(addresses_, ADDRESS_BURST, ADDRESS_PERIOD, now);
+    if((int)accounts_.size() > BUCKET_LIMIT) prune(accounts_, ACCOUNT_BURST, ACCOUNT_PERIOD, now);
+
+    if(refill(addresses_, address, ADDRESS_BURST, ADDRESS_PERIOD, now) < 1) {
+        cerr << "LOGIN: Throttled " << address << "\n";
+        return false;
+    }
+    if(account != "" && refill(accounts_, account, ACCOUNT_BURST, ACCOUNT_PERIOD, now) < 1) {
+        cerr << "LOGIN: Throttled attempts on " << account << "\n";
+        return false;
+    }
+
+    addresses_[address].tokens -= 1;
+    if(account != "") accounts_[account].tokens -= 1;
+    return true;
+}
+
+/**
+ *   @brief  Add the tokens earned since the last refill of a bucket, creating it full on first use.
+ *           mutex_ must be held.
+ *
+ *   @param  &buckets is the map the bucket is in
+ *   @param  &key is the address or account of the bucket
+ *   @param  burst is the capacity of the bucket
+ *   @param  period is the seconds to earn one token
+ *   @param  now is the current time
+ *
+ *   @return  double the tokens in the bucket
+ */
+double LoginThrottle::refill(unordered_map<string, TokenBucket> &buckets, const string &key,
+                             int burst, int period, Clock::time_point now) {
+    auto it = buckets.find(key);
+    if(it == buckets.end()) {
+        TokenBucket &bucket = buckets[key];
+        bucket.tokens = burst;
+        bucket.refilled = now;
+        return bucket.tokens;
+    }
+
+    TokenBucket &bucket = it->second;
+    double seconds = chrono::duration<double>(now - bucket.refilled).count();
+    bucket.tokens = min((double)burst, bucket.tokens + seconds / period);
+    bucket.refilled = now;
+    return bucket.tokens;
+}
+
+/**
+ *   @brief  Drop the buckets that have refilled completely, they are the same as new ones.
+ *           mutex_ must be held.
+ *
+ *   @param  &buckets is the map of buckets
+ *   @param  burst is the capacity of the buckets
+ *   @param  period is the seconds to earn one token
+ *   @param  now is the current time
+ *
+ *   @return  void
+ */
+void LoginThrottle::prune(unordered_map<string, TokenBucket> &buckets, int burst, int period, Clock::time_point now) {
+    for(auto it = buckets.begin(); it != buckets.end();) {
+        double seconds = chrono::duration<double>(now - it->second.refilled).count();
+        if(it->second.tokens + seconds / period >= burst) {
+            it = buckets.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+}
@@ -9,7 +9,8 @@
  *  @section    DESCRIPTION
  *
  *              This class represents the login screen. This screen accepts a username,
- *              password and confirms authentication.
+ *              password and confirms authentication. Passwords are checked on the hashing
+ *              workers and the result is posted back to the session.
  */
 
 #include <Wt/WApplication>
@@ -20,11 +21,13 @@
 #include <string>
 #include <stdio.h>
 #include <fstream>
-#include <openssl/sha.h>
+#include <boost/bind.hpp>
 
 #include "LoginWidget.h"
-#include "Hash.h"
+#include "HashPool.h"
 #include "Account.h"
+#include "AccountStore.h"
+#include "LoginThrottle.h"
 #include "Bridge.h"
 
 using namespace Wt;
@@ -34,15 +37,13 @@ using namespace std;
  *   @brief  Login Widget constructor
  *
  *   @param  *parent is a pointer the the containerwidget that stores this widget
- *   @param  *account is a pointer to the user account object
  *   @param  *main is a pointer to the app's welcome screen
  */
-LoginWidget::LoginWidget(WContainerWidget *parent, Account *account, WelcomeScreen *main):
+LoginWidget::LoginWidget(WContainerWidget *parent, WelcomeScreen *main):
 WContainerWidget(parent)
 {
     setContentAlignment(AlignCenter);
     parent_ = main;
-    account_ = account;
     setStyleClass("w3-animate-opacity");
 }
 
@@ -106,7 +107,7 @@ void LoginWidget::update()
 /**
  *   @brief  submit() function, triggered when user presses login button, displays
  *           any applicable warning messages and/or checks user database for authentication.
- *           Finally, it redirects to the bridge screen after successful login.
+ *           The password is checked on the hashing workers, credentialsChecked() finishes the login.
  */
 void LoginWidget::submit(){
     // checks if provided user account and password exist, shows error message if not found
@@ -115,71 +116,64 @@ void LoginWidget::submit(){
         statusMessage_->setHidden(false);
     }
     else if(!LoginWidget::checkCredentials(idEdit_->text().toUTF8(),pwEdit_->text().toUTF8())){
-        statusMessage_->setText("Invalid credentials!");
         statusMessage_->setHidden(false);
     }
-    else { // if successful, redirects to bridge page
-        parent_->loginSuccess();
+    else { // wait for the password check, one at a time
+        statusMessage_->setHidden(true);
+        loginButton_->setDisabled(true);
     }
 }
 
 /**
- *   @brief  checkCredentials() function, checks for username.txt, then compares
- *           encrypted version of the user's password
+ *   @brief  checkCredentials() function, throttles the attempt, looks the username up in the account
+ *           store, then queues the user's password to be checked against the stored hash
  *   @param  username is a string representing the user's inputted username
  *   @param  password is a string representing the user's inputted password
- *   @return bool representing if login successful
+ *   @return bool false if the login failed already, the status message says why
  */
 bool LoginWidget::checkCredentials(string username, string password) {
-    ifstream inFile;
-    string str;
-    string filename = "credentials/" + username + ".txt";
-    inFile.open(filename.c_str()); // opens username.txt
-    string hashedPW = Hash::sha256_hash(password); // cryptographically hash password
-
-    if (!inFile) {
-        return(false); // file not found
+    // too many attempts from this client or on this account are refused before any lookup
+    if (!LoginThrottle::instance()->allow(WApplication::instance()->environment().clientAddress(), username)) {
+        statusMessage_->setText("Too many attempts, please wait and try again.");
+        return(false);
+    }
+
+    // unknown accounts are answered from memory
+    Account stored("", "", username, "");
+    if (!AccountStore::instance()->load(username, stored)) {
+        statusMessage_->setText("Invalid credentials!");
+        return(false); // account not found
+    }
+
+    if (!HashPool::instance()->verify(password, stored.getPassword(), WApplication::instance()->sessionId(),
+                                      boost::bind(&LoginWidget::credentialsChecked, this, username, _1, _2))) {
+        statusMessage_->setText("The server is busy, please try again.");
+        return(false);
+    }
+    return true;
+}
+
+/**
+ *   @brief  credentialsChecked() function, called in this session once the password was checked.
+ *           Logs the user in if it matched. A password stored
+ *           with an older hash is replaced with the upgraded one.
+ *   @param  username is a string representing the user's inputted username
+ *   @param  matched is true if the password matched
+ *   @param  upgraded is the password hashed with the current settings, empty if the stored hash is current
+ */
+void LoginWidget::credentialsChecked(string username, bool matched, string upgraded) {
+    loginButton_->setDisabled(false);
+
+    // if successful, shares the account with the user's other sessions and redirects to bridge page
+    if (!matched || !parent_->loginSuccess(username)) {
+        statusMessage_->setText("Invalid credentials!");
+        statusMessage_->setHidden(false);
+        WApplication::instance()->triggerUpdate();
+        return;
     }
 
-    getline(inFile, str); //read hashed password from username.txt
-    if(str.compare(hashedPW) == 0) {
-        account_->setPassword(hashedPW);
-        account_->setEmail(username);
-        getline(inFile, str);
-        account_->setFirstName(str);
-        getline(inFile, str);
-        account_->setLastName(str);
-        while(getline(inFile, str)) {
-            //get bridge name
-            int beginIndex = 0;
-            int endIndex = str.find(",", beginIndex + 1);
-            string bname = str.substr(beginIndex, endIndex - beginIndex);
-
-            //get bridge location
-            beginIndex = endIndex + 2;
-            endIndex = str.find(",", beginIndex + 1);
-            string bloc = str.substr(beginIndex, endIndex - beginIndex);
-
-            //get bridge ip
-            beginIndex = endIndex + 2;
-            endIndex = str.find(",", beginIndex + 1);
-            string bip = str.substr(beginIndex, endIndex - beginIndex);
-
-            //get bridge port
-            beginIndex = endIndex + 2;
-            endIndex = str.find(",", beginIndex + 1);
-            string bport = str.substr(beginIndex, endIndex - beginIndex);
-
-            //get bridge username
-            beginIndex = endIndex + 2;
-            endIndex = str.find('\n', beginIndex + 1);
-            string buser = str.substr(beginIndex, endIndex - beginIndex);
-
-            account_->addBridge(bname, bloc, bip, bport, buser);
-        }
-        inFile.close();
-        return true;
+    if (upgraded != "") {
+        parent_->getAccount()->update(boost::bind(&Account::setPassword, _1, upgraded)); //update account store
     }
-    inFile.close();
-    return false;
+    WApplication::instance()->triggerUpdate();
 }
@@ -18,6 +18,9 @@
 #include <Wt/WBootstrapTheme>
 
 #include "WelcomeScreen.h"
+#include "AccountStore.h"
+#include "ProfilePicture.h"
+#include "ProfilePictureResource.h"
 
 using namespace Wt;
 using namespace std;
@@ -37,6 +40,11 @@ Wt::WApplication *createApplication(const Wt::WEnvironment& env)
 
     app->setTheme(new Wt::WBootstrapTheme(app));
     app->useStyleSheet("style/stylesheet.css");
+    //colour picker previews are drawn in the browser
+    app->require("js/colourpreview.js");
+
+    //bridge responses are pushed to the browser when they arrive instead of holding the page
+    app->enableUpdates(true);
 
 
     new WelcomeScreen(app->root());
@@ -50,7 +58,13 @@ int main(int argc, char **argv)
 
     server.addEntryPoint(Wt::Application, createApplication);
 
+    //profile picture thumbnails, cached by the browser until the picture changes
+    server.addResource(new ProfilePictureResource(), ProfilePicture::RESOURCE_PATH);
+
     server.run();
+
+    //write accounts saved since the last flush
+    AccountStore::instance()->flush();
   } catch (Wt::WServer::Exception& e) {
     std::cerr << e.what() << std::endl;
   } catch (std::exception &e) {
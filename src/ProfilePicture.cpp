@@ -0,0 +1,177 @@
+/**
+ *  @file       ProfilePicture.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application profile picture thumbnails
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This class turns an uploaded picture into the thumbnails the application shows,
+ *              once, when it is uploaded. The picture is cropped to a square and scaled to
+ *              each thumbnail size, and the thumbnails are named by the SHA256 of the upload,
+ *              so a picture is stored once however many accounts use it and a new picture
+ *              always gets a new URL. Thumbnails are served by ProfilePictureResource.
+ */
+
+#include <Wt/WPainter>
+#include <Wt/WRasterImage>
+#include <Wt/WRectF>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include "ProfilePicture.h"
+#include "Hash.h"
+
+using namespace Wt;
+
+const char *ProfilePicture::DIRECTORY = "thumbnails";
+const char *ProfilePicture::DEFAULT_PICTURE = "Wt/images/default_ppic.png";
+const char *ProfilePicture::RESOURCE_PATH = "/ppic";
+
+namespace {
+
+const int SIZES[] = { ProfilePicture::SMALL, ProfilePicture::LARGE };
+
+}
+
+/**
+ *   @brief  Make the thumbnails of a picture
+ *
+ *   @param  &file is the picture, a PNG, JPEG or GIF
+ *
+ *   @return  string the id of the picture, the SHA256 of the file, empty if it could not be read
+ */
+string ProfilePicture::store(const string &file) {
+    ifstream in(file.c_str(), ios::binary);
+    string contents((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+    if (!in.good() && !in.eof()) return "";
+    if (contents.empty()) return "";
+
+    string picture = Hash::sha256_hash(contents);
+
+    boost::system::error_code err;
+    boost::filesystem::create_directories(DIRECTORY, err);
+    if (err) {
+        cerr << "PICTURE: Could not create " << DIRECTORY << ": " << err.message() << "\n";
+        return "";
+    }
+
+    int width = 0;
+    int height = 0;
+    try {
+        WPainter::Image image(file, file); // reads the size from the file
+        width = image.width();
+        height = image.height();
+    }
+    catch (std::exception &e) {
+        cerr << "PICTURE: Could not read " << file << ": " << e.what() << "\n";
+        return "";
+    }
+    if (width <= 0 || height <= 0) return "";
+
+    for (int size : SIZES) {
+        string thumbnail = path(picture, size);
+        //the same upload was stored before
+        if (boost::filesystem::exists(thumbnail, err)) continue;
+        if (!writeThumbnail(file, width, height, size, thumbnail)) return "";
+    }
+    return picture;
+}
+
+/**
+ *   @brief  URL of a thumbnail, the same for as long as the picture does not change
+ *
+ *   @param  &picture is the id of the picture, empty for the default picture
+ *   @param  size is the width and height of the thumbnail, SMALL or LARGE
+ *
+ *   @return  string the URL
+ */
+string ProfilePicture::url(const string &picture, int size) {
+    string id = picture != "" ? picture : defaultPicture();
+    if (id == "") return "images/default_ppic.png";
+    return string(RESOURCE_PATH) + "?id=" + id + "&size=" + to_string(size);
+}
+
+/**
+ *   @brief  File of a thumbnail
+ *
+ *   @param  &picture is the id of the picture
+ *   @param  size is the width and height of the thumbnail
+ *
+ *   @return  string the path of the PNG file
+ */
+string ProfilePicture::path(const string &picture, int size) {
+    return string(DIRECTORY) + "/" + picture + "-" + to_string(size) + ".png";
+}
+
+/**
+ *   @brief  Check that a picture id and size name a thumbnail that can be stored, ids come from URLs
+ *
+ *   @param  &picture is the id of the picture
+ *   @param  size is the width and height of the thumbnail
+ *
+ *   @return  bool true if the id is a SHA256 and the size is one of the thumbnail sizes
+ */
+bool ProfilePicture::isThumbnail(const string &picture, int size) {
+    if (picture.size() != 64) return false;
+    for (char c : picture) {
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+    }
+    return find(begin(SIZES), end(SIZES), size) != end(SIZES);
+}
+
+/**
+ *   @brief  Id of the default picture, its thumbnails are made the first time it is needed
+ *
+ *   @return  string the id, empty if the default picture could not be read
+ */
+string ProfilePicture::defaultPicture() {
+    static const string picture = store(DEFAULT_PICTURE);
+    return picture;
+}
+
+/**
+ *   @brief  Crop a picture to a square around its centre, scale it and write it as a PNG. The
+ *           file is written under a temporary name and renamed, so it is never read half written.
+ *
+ *   @param  &file is the picture
+ *   @param  width is the width of the picture
+ *   @param  height is the height of the picture
+ *   @param  size is the width and height of the thumbnail
+ *   @param  &path is the file to write
+ *
+ *   @return  bool false if the thumbnail could not be written
+ */
+bool ProfilePicture::writeThumbnail(const string &file, int width, int height, int size, const string &path) {
+    int side = min(width, height);
+    WRasterImage thumbnail("png", size, size);
+    {
+        WPainter painter(&thumbnail);
+        painter.setRenderHint(WPainter::SmoothPixmapTransform);
+        painter.drawImage(WRectF(0, 0, size, size), WPainter::Image(file, width, height),
+                          WRectF((width - side) / 2, (height - side) / 2, side, side));
+        painter.end();
+    }
+
+    string temporary = path + ".tmp";
+    {
+        ofstream out(temporary.c_str(), ios::binary);
+        thumbnail.write(out);
+        if (!out.good()) {
+            cerr << "PICTURE: Could not write " << temporary << "\n";
+            return false;
+        }
+    }
+
+    boost::system::error_code err;
+    boost::filesystem::rename(temporary, path, err);
+    if (err) {
+        cerr << "PICTURE: Could not write " << path << ": " << err.message() << "\n";
+        return false;
+    }
+    return true;
+}
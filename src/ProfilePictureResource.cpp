@@ -0,0 +1,78 @@
+/**
+ *  @file       ProfilePictureResource.cpp
+ *  @author     CS 3307 - Team 13
+ *  @date       10/17/2026
+ *  @version    1.0
+ *
+ *  @brief      CS 3307, Hue Light Application resource serving profile picture thumbnails
+ *
+ *  @section    DESCRIPTION
+ *
+ *              This resource serves the thumbnails made by ProfilePicture. A thumbnail's URL
+ *              names its content, so it never changes: responses carry a strong ETag and may
+ *              be kept by the browser for a year, and a browser asking again with the ETag
+ *              gets an empty 304 response.
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include "ProfilePictureResource.h"
+#include "ProfilePicture.h"
+
+using namespace Wt;
+using namespace std;
+
+/**
+ *   @brief  ProfilePictureResource constructor
+ *
+ *   @param  *parent is the owner of the resource
+ */
+ProfilePictureResource::ProfilePictureResource(WObject *parent) :
+WResource(parent)
+{
+}
+
+/**
+ *   @brief  ProfilePictureResource destructor, waits for requests being served
+ *
+ */
+ProfilePictureResource::~ProfilePictureResource() {
+    beingDeleted();
+}
+
+/**
+ *   @brief  Serve the thumbnail named by the id and size parameters
+ *
+ *   @param  &request is the request
+ *   @param  &response is the response
+ *
+ *   @return  void
+ */
+void ProfilePictureResource::handleRequest(const Http::Request &request, Http::Response &response) {
+    const string *id = request.getParameter("id");
+    const string *size = request.getParameter("size");
+    int pixels = size ? atoi(size->c_str()) : 0;
+    if (!id || !ProfilePicture::isThumbnail(*id, pixels)) {
+        response.setStatus(404);
+        return;
+    }
+
+    ifstream in(ProfilePicture::path(*id, pixels).c_str(), ios::binary);
+    if (!in) {
+        response.setStatus(404);
+        return;
+    }
+
+    string etag = "\"" + *id + "-" + to_string(pixels) + "\"";
+    response.addHeader("ETag", etag);
+    response.addHeader("Cache-Control", "public, max-age=" + to_string(MAX_AGE) + ", immutable");
+
+    //the browser has this thumbnail already
+    if (request.headerValue("If-None-Match").find(etag) != string::npos) {
+        response.setStatus(304);
+        return;
+    }
+
+    response.setMimeType("image/png");
+    response.out() << in.rdbuf();
+}
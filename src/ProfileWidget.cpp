@@ -29,11 +29,14 @@
 #include <stdio.h>
 #include <fstream>
 #include <openssl/sha.h>
+#include <boost/bind.hpp>
+#include <boost/filesystem.hpp>
 
 
 #include "ProfileWidget.h"
 #include "Account.h"
-#include "Hash.h"
+#include "HashPool.h"
+#include "ProfilePicture.h"
 
 using namespace Wt;
 using namespace std;
@@ -114,9 +117,9 @@ void ProfileWidget::update()
     picturetitle->setStyleClass("title");
     new WBreak(this);
 
-    WImage *picture = new WImage(WLink("images/ppics/" + account_->getEmail() + "?" + to_string(WTime::currentTime().minute()) + to_string(WTime::currentTime().second()) +
-                                       to_string(WTime::currentTime().msec())) );
-    picture->resize(100,100);
+    // the URL names the picture, so the browser only downloads it when it changes
+    WImage *picture = new WImage(WLink(ProfilePicture::url(account_->getPicture(), ProfilePicture::LARGE)));
+    picture->resize(ProfilePicture::LARGE, ProfilePicture::LARGE);
     addWidget(picture);
 
     picUpload_ = new WFileUpload();
@@ -135,6 +138,8 @@ void ProfileWidget::update()
 
     if (fileTooLarge)
         profilePicOutMessage_->setText("Sorry, file too large. Cannot update picture");
+    else if (pictureUnreadable)
+        profilePicOutMessage_->setText("Sorry, the file is not a picture. Cannot update picture");
 
 
     //upload automatically when the user entered a file
@@ -145,44 +150,35 @@ void ProfileWidget::update()
                                   }));
    picUpload_->uploaded().connect(bind([=] {
         profilePicOutMessage_->setText("Upload successful");
-        ProfileWidget::uploadProfilePicture(picUpload_->spoolFileName());
+        pictureUnreadable = !ProfileWidget::uploadProfilePicture(picUpload_->spoolFileName());
         fileTooLarge = false;
         update();
                                    }));
     picUpload_->fileTooLarge().connect(bind([=] {
         profilePicOutMessage_->setText("File too large");
         fileTooLarge = true;
+        pictureUnreadable = false;
         update();
 
                                    }));
 }
 
 /**
-*   @brief  uploadProfilePicture function, called if user uploads a profile picture, saves the file in a non-temporary location
+*   @brief  uploadProfilePicture function, called if user uploads a profile picture, makes its thumbnails and sets it as the Account's picture
 *
 *   @param  location of the temporary file location
 *
-*   @return  void
+*   @return  true if the picture was stored, false if it could not be read
 */
-void ProfileWidget::uploadProfilePicture(string fileLocation) {
-
-        // creates profile pictures folder if one does not exist
-    const int dir_err = system("mkdir -p Wt/images/ppics");
-    if (-1 == dir_err)
-    {
-        cout << "ERROR - Could not create directory\n";
-        exit(1);
-    }
-
-
-    string file = "Wt/images/ppics/" + account_->getEmail(); // file extension?
+bool ProfileWidget::uploadProfilePicture(string fileLocation) {
 
-    ifstream in (fileLocation.c_str());
-    ofstream writefile(file.c_str());
-    writefile << in.rdbuf();
-    writefile.close();
-    in.close();
+    string picture = ProfilePicture::store(fileLocation);
+    if (picture == "")
+        return false;
 
+    account_->update(boost::bind(&Account::setPicture, _1, picture)); //update account store
+    parent_->updateProfilePicture(); //display new picture in the menu bar
+    return true;
 }
 
 
@@ -192,8 +188,8 @@ void ProfileWidget::uploadProfilePicture(string fileLocation) {
 *   @return  void
 */
 void ProfileWidget::updateFirstName() {
-    account_->setFirstName(editableFirstName_->text().toUTF8()); // call setter to change account first name
-    account_->writeFile(); //update credentials file
+    // call setter to change account first name in the account store
+    account_->update(boost::bind(&Account::setFirstName, _1, editableFirstName_->text().toUTF8()));
     parent_->updateProfileName(); //display new name
 }
 
@@ -205,8 +201,8 @@ void ProfileWidget::updateFirstName() {
 *   @return  void
 */
 void ProfileWidget::updateLastName() {
-    account_->setLastName(editableLastName_->text().toUTF8()); // call setter to change the account last name
-    account_->writeFile(); //update credentials file
+    // call setter to change the account last name in the account store
+    account_->update(boost::bind(&Account::setLastName, _1, editableLastName_->text().toUTF8()));
     parent_->updateProfileName(); //display new name
 }
 
@@ -271,11 +267,24 @@ void ProfileWidget::showPasswordDialog() {
 
     // when the user is finished, call the updatePassword function
     passwordDialog_->finished().connect(this, &ProfileWidget::updatePassword);
+    passwordDialog_->finished().connect(boost::bind(&ProfileWidget::closeDialog, this, passwordDialog_));
     passwordDialog_->show();
 }
 
 /**
-*   @brief  updatePassword function, called upon submission of the update password dialog box. Validates password and sets the Account's new password using Account setter
+*   @brief  closeDialog function, deletes a dialog once its finished handler has run
+*
+*   @param  *dialog is the dialog that finished
+*
+*   @return  void
+*/
+void ProfileWidget::closeDialog(WDialog *dialog) {
+    delete dialog;
+}
+
+/**
+*   @brief  updatePassword function, called upon submission of the update password dialog box. Validates the new password
+*           and queues the current one to be checked on the hashing workers, currentPasswordChecked continues
 *
 *   @return  void
 */
@@ -285,22 +294,47 @@ void ProfileWidget::updatePassword() {
     if (passwordDialog_->result() == WDialog::DialogCode::Rejected)
         return;
 
-    // otherwise, update their password and do validation
+    // otherwise, update their password and do validation, the dialog is gone once the check is back
     string currentPassword = currentPass_->text().toUTF8();
     string newPassword = newPass_->text().toUTF8();
     string confirmNewPassword = confirmNewPass_->text().toUTF8();
+    bool newPasswordValid = newPass_->validate() && (!confirmNewPass_->text().toUTF8().compare("") == 0);
 
     // error/success messages hidden by default
     passwordError_->setHidden(true);
     passwordSuccess_->setHidden(true);
 
-    if (checkValidPassword(currentPassword)) { // if the password they entered as past password is correct
-        if (newPass_->validate() && (!confirmNewPass_->text().toUTF8().compare("") == 0)) { // if length requirements of new password are met
+    if (!HashPool::instance()->verify(currentPassword, account_->getPassword(), WApplication::instance()->sessionId(),
+                                      boost::bind(&ProfileWidget::currentPasswordChecked, this,
+                                                  newPassword, confirmNewPassword, newPasswordValid, _1))) {
+        passwordError_->setText("The server is busy, please try again."); // else show error message
+        passwordError_->setHidden(false);
+    }
+}
+
+/**
+*   @brief  currentPasswordChecked function, called in this session once the current password was checked. Queues the new password
+*           to be hashed if the current one is correct and the new one is valid, passwordHashed stores it
+*
+*   @param  newPassword is the new password
+*   @param  confirmNewPassword is the confirmation of the new password
+*   @param  newPasswordValid is true if the new password meets the length requirements
+*   @param  matched is true if the current password is correct
+*
+*   @return  void
+*/
+void ProfileWidget::currentPasswordChecked(string newPassword, string confirmNewPassword, bool newPasswordValid, bool matched) {
+
+    if (matched) { // if the password they entered as past password is correct
+        if (newPasswordValid) { // if length requirements of new password are met
             if (newPassword.compare(confirmNewPassword) == 0) { // if password is equal to the confirmed password
-                account_->setPassword(Hash::sha256_hash(newPassword)); // then hash their inputed password, and update Account details
-                account_->writeFile(); //update credentials file
-                passwordSuccess_->setHidden(false); // show the success message
+                // then hash their inputed password, and update Account details
+                if (!HashPool::instance()->hash(newPassword, WApplication::instance()->sessionId(),
+                                                boost::bind(&ProfileWidget::passwordHashed, this, _1))) {
+                    passwordError_->setText("The server is busy, please try again."); // else show error message
+                    passwordError_->setHidden(false);
                 }
+            }
             else {
                 passwordError_->setText("Sorry, the passwords you have entered do not match."); // else show error message
                 passwordError_->setHidden(false);
@@ -315,15 +349,25 @@ void ProfileWidget::updatePassword() {
         passwordError_->setText("You have not entered a valid password"); // else show error message
         passwordError_->setHidden(false);
     }
+    WApplication::instance()->triggerUpdate();
 }
 
 /**
-*   @brief  checkValidPassword function, ensures that the password that the user has entered is the password connected to their account
+*   @brief  passwordHashed function, called in this session with the hash of the new password, sets the Account's new password
+*
+*   @param  hashed is the hash of the new password, empty if it could not be made
 *
-*   @return  bool true if the password is correct, false otherwise
+*   @return  void
 */
-bool ProfileWidget::checkValidPassword(string password) {
-    string hashedPass = Hash::sha256_hash(password); // hash pass and compare to file
-    return (hashedPass.compare(account_->getPassword()) == 0);
+void ProfileWidget::passwordHashed(string hashed) {
+    if (hashed == "") {
+        passwordError_->setText("Sorry, your password could not be updated."); // else show error message
+        passwordError_->setHidden(false);
+    }
+    else {
+        account_->update(boost::bind(&Account::setPassword, _1, hashed)); //update account store
+        passwordSuccess_->setHidden(false); // show the success message
+    }
+    WApplication::instance()->triggerUpdate();
 }
 
@@ -12,6 +12,7 @@
  */
 
 #include "Schedule.h"
+#include <stdlib.h>
 
 /**
  *   @brief  Schedule constructor
@@ -20,46 +21,14 @@
  *   @param  scheduleData the Json object of a Schedule from the Hue API
  *
  */
-Schedule::Schedule(WString scheduleNum, Json::Object scheduleData) {
-    schedulenum_ = scheduleNum;
-    if(scheduleData.type("name") != 0) name_ = scheduleData.get("name");
-    else name_ = "";
+Schedule::Schedule(WString scheduleNum, const Json::Object &scheduleData) {
+    num_ = atoi(scheduleNum.toUTF8().c_str());
+    name_ = scheduleData.get("name").orIfNull("").toUTF8();
+    description_ = scheduleData.get("description").orIfNull("").toUTF8();
+    time_ = scheduleData.get("time").orIfNull("").toUTF8();
     
-    if(scheduleData.type("description") != 0) description_ = scheduleData.get("description");
-    else description_ = "";
-    
-    if(scheduleData.type("time") != 0) time_ = scheduleData.get("time");
-    else time_ = "";
-    
-    Json::Object command = scheduleData.get("command");
-    if(command.type("address") != 0) address_ = command.get("address");
-    else address_ = "";
-    
-    if(command.type("method") != 0) method_ = command.get("method");
-    else method_ = "";
-    
-    Json::Object body = command.get("body");
-    if(body.type("transition") != 0) transition_ = body.get("transition");
-    else transition_ = -1;
-    
-    if(body.type("bri") != 0) bri_ = body.get("bri");
-    else bri_ = -1;
-    
-    if(body.type("transition") != 0) transition_ = body.get("transition");
-    else transition_ = 4; //default value from Hue is 0.4s (400ms)
-    
-    if(body.type("on") != 0) on_ = body.get("on");
-    else on_ = 0;
-    
-    if(body.type("xy") != 0) {
-        Json::Array xy = body.get("xy");
-        xy_.push_back(xy[0]);
-        xy_.push_back(xy[1]);
-    }
-    else {
-        xy_.push_back(-1.0);
-        xy_.push_back(-1.0);
-    }
+    const Json::Object &command = scheduleData.get("command");
+    setCommand(command);
 }
 
 /**
@@ -69,3 +38,30 @@ Schedule::Schedule(WString scheduleNum, Json::Object scheduleData) {
 Schedule::~Schedule() {
     
 }
+
+/**
+ *   @brief  Set the command run by the Schedule
+ *
+ *   @param  command the Json command object of a Schedule from the Hue API
+ *
+ *   @return  void
+ */
+void Schedule::setCommand(const Json::Object &command) {
+    address_ = command.get("address").orIfNull("").toUTF8();
+    method_ = HueTypes::intern(command.get("method").orIfNull("").toUTF8());
+    
+    const Json::Object &body = command.get("body");
+    bri_ = body.get("bri").orIfNull(-1);
+    transition_ = body.get("transition").orIfNull(4); //default value from Hue is 0.4s (400ms)
+    on_ = body.get("on").orIfNull(false);
+    
+    if(body.type("xy") != 0) {
+        const Json::Array &xy = body.get("xy");
+        xy_[0] = (double)xy[0];
+        xy_[1] = (double)xy[1];
+    }
+    else {
+        xy_[0] = -1.0;
+        xy_[1] = -1.0;
+    }
+}
@@ -34,6 +34,9 @@
 #include "BridgeScreenWidget.h"
 #include "ProfileWidget.h"
 #include "LightManagementWidget.h"
+#include "BridgeClient.h"
+#include "AccountRegistry.h"
+#include "ProfilePicture.h"
 
 using namespace Wt;
 using namespace std;
@@ -45,11 +48,13 @@ using namespace std;
  */
 WelcomeScreen::WelcomeScreen(WContainerWidget *parent):
 WContainerWidget(parent),
+ppic_(0),
 createScreen_(0),
 loginScreen_(0),
 bridgeScreen_(0),
 profileScreen_(0),
-account_("","","","") {
+lightManage_(0),
+account_(make_shared<Account>("","","","")) {
     //resets URL to base /ambience/ , helpful for logout and page refreshes
     WApplication::instance()->setInternalPath("", false);
 
@@ -61,9 +66,7 @@ account_("","","","") {
 
 
     //background colour of application
-    WCssDecorationStyle *bgCss = new WCssDecorationStyle();
-    bgCss->setBackgroundImage(WLink("images/bulb.png"));
-    setDecorationStyle(*bgCss);
+    decorationStyle().setBackgroundImage(WLink("images/bulb.png"));
     //minimum window size of application
     setMinimumSize(800,768);
 
@@ -138,7 +141,7 @@ account_("","","","") {
  *   @return  void
  */
 void WelcomeScreen::handleInternalPath(const string &internalPath) {
-    if (account_.isAuth()) {
+    if (account_->isAuth()) {
         serverMessage_->setHidden(true);
         profileMenuItem_->setHidden(false);
         bridgesMenuItem_->setHidden(false);
@@ -151,6 +154,11 @@ void WelcomeScreen::handleInternalPath(const string &internalPath) {
 
         regex re("/bridges/(\\d{1,3})");
 
+        //a hidden light management screen would keep the bridge polled for nothing
+        if (lightManage_ && !regex_match(internalPath, re)) {
+            lightManage_->stopWatching();
+        }
+
         if (internalPath == "/bridges") { // opens bridge page
             bridgeScreen();
         }
@@ -189,6 +197,25 @@ void WelcomeScreen::handleInternalPath(const string &internalPath) {
     }
 }
 
+/**
+ *   @brief  Returns the HTTP client service of a Bridge, creating it on first use. All screens of
+ *           the session share it so requests to one Bridge reuse the same connections.
+ *
+ *   @param  ip is the ip of the bridge URL
+ *   @param  port is the port of the bridge URL
+ *
+ *   @return BridgeClient* the client service for the bridge
+ */
+BridgeClient *WelcomeScreen::getBridgeClient(string ip, string port) {
+    string key = ip + ":" + port;
+    BridgeClient *client = bridgeClients_[key];
+    if(!client) {
+        client = new BridgeClient(ip, port, this);
+        bridgeClients_[key] = client;
+    }
+    return client;
+}
+
 /**
  *   @brief  Creates a new LightManagementWidget for a Bridge in in the Account bridges vector at index.
  *
@@ -197,10 +224,23 @@ void WelcomeScreen::handleInternalPath(const string &internalPath) {
  *   @return void
  */
 void WelcomeScreen::lightManagementScreen(int index) {
-    Bridge *bridge = account_.getBridgeAt(index);
+    //the path may name a bridge another session removed meanwhile, the list is read once
+    shared_ptr<const vector<Bridge> > bridges = account_->getBridges();
+    if (index >= (int)bridges->size()) {
+        WApplication::instance()->setInternalPath("/bridges", true);
+        return;
+    }
 
     //create new LMW on view because bridge data may have changed since last view
-    lightManage_ = new LightManagementWidget(mainStack_, bridge, this);
+    delete lightManage_;
+
+    //the account is shared with the user's other sessions, this session views its own copy of the bridge
+    viewedBridge_.reset(new Bridge((*bridges)[index]));
+    auto state = bridgeStates_.find(viewedBridge_->getKey());
+    if(state != bridgeStates_.end()) {
+        viewedBridge_->setState(state->second);
+    }
+    lightManage_ = new LightManagementWidget(mainStack_, viewedBridge_.get(), this);
     mainStack_->setCurrentWidget(lightManage_);
     lightManage_->update();
 }
@@ -212,7 +252,7 @@ void WelcomeScreen::lightManagementScreen(int index) {
  */
 void WelcomeScreen::createAccountScreen() {
     if (!createScreen_) {
-        createScreen_ = new CreateAccountWidget(mainStack_, &account_, this);
+        createScreen_ = new CreateAccountWidget(mainStack_, this);
     }
     mainStack_->setCurrentWidget(createScreen_);
     createScreen_->update();
@@ -225,21 +265,38 @@ void WelcomeScreen::createAccountScreen() {
  */
 void WelcomeScreen::profileScreen() {
     if (!profileScreen_) {
-        profileScreen_ = new ProfileWidget(mainStack_, &account_, this);
+        profileScreen_ = new ProfileWidget(mainStack_, account_.get(), this);
     }
     mainStack_->setCurrentWidget(profileScreen_);
     profileScreen_->update();
 }
 
 /**
- *   @brief  Validates user account to logged in after successful login.
- *   @return void
+ *   @brief  Validates user account to logged in after successful login. The account is shared
+ *           with the other sessions of the user.
+ *   @param  email is the email of the user that logged in
+ *   @return bool false if the account could not be loaded
  */
-void WelcomeScreen::loginSuccess() {
-    account_.setAuth(true); //set account to authorized (logged in status)
+bool WelcomeScreen::loginSuccess(const string &email) {
+    shared_ptr<Account> account = AccountRegistry::instance()->acquire(email);
+    if (!account) return false;
+
+    account_ = account;
+    account_->setAuth(true); //set account to authorized (logged in status)
     bridgesMenuItem_->select(); //click bridge menu item
 
     WApplication::instance()->setInternalPath("/bridges", true);
+    return true;
+}
+
+/**
+ *   @brief  Keeps the state loaded for a bridge in this session, for the light management screen
+ *   @param  key is the bridge key, ip:port:username
+ *   @param  state is the snapshot of the bridge
+ *   @return void
+ */
+void WelcomeScreen::setBridgeState(const string &key, shared_ptr<BridgeState> state) {
+    bridgeStates_[key] = state;
 }
 
 /**
@@ -249,7 +306,7 @@ void WelcomeScreen::loginSuccess() {
  */
 void WelcomeScreen::loginScreen() {
     if (!loginScreen_) {
-        loginScreen_ = new LoginWidget(mainStack_, &account_, this);
+        loginScreen_ = new LoginWidget(mainStack_, this);
     }
     mainStack_->setCurrentWidget(loginScreen_);
     loginScreen_->update();
@@ -262,25 +319,37 @@ void WelcomeScreen::loginScreen() {
  */
 void WelcomeScreen::bridgeScreen() {
     if (!bridgeScreen_) {
-        bridgeScreen_ = new BridgeScreenWidget(mainStack_, &account_, this);
+        bridgeScreen_ = new BridgeScreenWidget(mainStack_, account_.get(), this);
     }
-    if (ppic_)
-        picContainer_->removeWidget(ppic_);
-    ppic_ = new WImage(WLink("images/ppics/" + account_.getEmail() + "?" + to_string(WTime::currentTime().minute()) + to_string(WTime::currentTime().second()) +
-                                       to_string(WTime::currentTime().msec())) , picContainer_);
-    ppic_->setStyleClass("img-circle");
-    ppic_->resize(50,50);
+    updateProfilePicture();
     mainStack_->setCurrentWidget(bridgeScreen_);
     bridgeScreen_->update();
 }
 
+/**
+ *   @brief  Shows the logged in user's picture on the top menu bar, the URL only
+ *           changes with the picture so the browser keeps it cached otherwise
+ *
+ *   @return void
+ */
+void WelcomeScreen::updateProfilePicture() {
+    WLink link(ProfilePicture::url(account_->getPicture(), ProfilePicture::SMALL));
+    if (ppic_) {
+        ppic_->setImageLink(link);
+        return;
+    }
+    ppic_ = new WImage(link, picContainer_);
+    ppic_->setStyleClass("img-circle");
+    ppic_->resize(ProfilePicture::SMALL, ProfilePicture::SMALL);
+}
+
 /**
  *   @brief  Updates name of logged in user on the top menu bar
  *
  *   @return void
  */
 void WelcomeScreen::updateProfileName() {
-    profileMenuItem_->setText("Profile (" + account_.getFirstName() + " " + account_.getLastName() + ")");
+    profileMenuItem_->setText("Profile (" + account_->getFirstName() + " " + account_->getLastName() + ")");
 }
 
 